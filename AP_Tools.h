@@ -2,11 +2,37 @@
 #define __AP_TOOLS__
 
 #include <sys/types.h>
-#include <sys/times.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include "error.h"
 #include "types.h"
 #include "boundeddeque.h"
+#include "binaryheap.h"
+#include "threadpool.h"
+#include "numaplacement.h"
+#include "reducedcosts.h"
+#include "hopcroftkarp.h"
+
+// Maximum number of candidates per person of the candidate cache (see 'candidate_cache').
+#define AS_MAX_CANDIDATES		64
+
+// The orders in which the persons bid in the sequential auction (see 'queue_policy').
+#define AS_QUEUE_LIFO			0
+#define AS_QUEUE_FIFO			1
+#define AS_QUEUE_EVICTED_FIRST	2
+#define AS_QUEUE_PRICE			3
+#define AS_QUEUE_DEGREE			4
+
+// The orders of the vertices of 'AS_Reorder_graph'.
+#define AS_ORDER_BFS			1
+#define AS_ORDER_RCM			2
+
+// Minimum number of bids in a round of the parallel (Jacobi) auction for the bids to be computed by all
+// the threads. Smaller rounds are computed by the calling thread, since waking up the workers costs more.
+#define AS_MIN_PARALLEL_BIDS	256
 
 //******************************************************************************
 // AUXILARY FUNCTIONS
@@ -14,18 +40,27 @@
 // Allocates memory for an array using 'malloc', deleting the current memory allocated, if any.
 // To detect memory currently allocated it tests for non NULL value of the pointer.
 // The size is in bytes.
-void		Allocate_array(char **array, int size)
+// The pointer is passed as 'char**' whatever its type, so it is read and written with 'memcpy': otherwise the
+// compiler may assume that the pointer of the caller did not change (strict aliasing).
+void		Allocate_array(char **array, long int size)
 {
-	if (*array != NULL) free(*array);
-	*array = NULL;
-	*array = malloc(size);
+	char	*pointer;
+	
+	memcpy(&pointer, array, sizeof(char*));
+	free(pointer);
+	pointer = (char*) malloc(size);
+	memcpy(array, &pointer, sizeof(char*));
 }
 
 // Frees the memory allocated to a pointer, and sets the pointer to NULL.
 void		Delete_array(char **array)
 {
-	free(*array);
-	*array = NULL;
+	char	*pointer;
+	
+	memcpy(&pointer, array, sizeof(char*));
+	free(pointer);
+	pointer = NULL;
+	memcpy(array, &pointer, sizeof(char*));
 }
 
 // Given an int value, reverse its bytes.
@@ -36,18 +71,222 @@ void		Swap_endianness_int(int *v)
 	for(char i = 0; i < size; ++i) ((char*)v)[i] = ((char*)&aux)[size - i - 1];
 }
 
-// Function to compute time durations. Given two calls to 'My_time' storing the values
-// in 'start_time' and 'end_time', the time duration in seconds is:
-// 'time = (end_time - start_time) / sysconf(_SC_CLK_TCK)'.
-unsigned	My_time()
+// Given 'count' pairs of Big-Endian int values in 'pairs', put the first value of each pair in 'first' and the
+// second one in 'second', in the byte order of the machine. Returns the maximum absolute value of the second values.
+int			Swap_endianness_pairs(const int *pairs, int *first, costType *second, int count)
+{
+	int		max_abs = 0;
+	int		value = 0;
+	
+	for(int k = 0; k < count; ++k)
+	{
+		first[k] = (int)__builtin_bswap32((unsigned)pairs[2 * k]);
+		value = (int)__builtin_bswap32((unsigned)pairs[2 * k + 1]);
+		second[k] = (costType)value;
+		if (abs(value) > max_abs) max_abs = abs(value);
+	}
+	return max_abs;
+}
+
+#ifdef RC_X86_KERNELS
+// AVX2 version of 'Swap_endianness_pairs': each 32 bytes hold 4 pairs, a byte shuffle reverses the bytes of the
+// values and groups the first and second values of each 128 bits lane, and a permutation joins the two lanes.
+__attribute__((target("avx2")))
+int			Swap_endianness_pairs_avx2(const int *pairs, int *first, costType *second, int count)
+{
+	const __m256i	shuffle = _mm256_setr_epi8(3, 2, 1, 0, 11, 10, 9, 8, 7, 6, 5, 4, 15, 14, 13, 12,
+									3, 2, 1, 0, 11, 10, 9, 8, 7, 6, 5, 4, 15, 14, 13, 12);
+	__m256i			values;
+	__m256i			max_abs = _mm256_setzero_si256();
+	__m128i			seconds;
+	int				lanes[4];
+	int				result = 0;
+	int				k = 0;
+	
+	for(; k + 4 <= count; k += 4)
+	{
+		values = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(pairs + 2 * k)), shuffle);
+		values = _mm256_permute4x64_epi64(values, 0xD8);
+		_mm_storeu_si128((__m128i*)(first + k), _mm256_castsi256_si128(values));
+		seconds = _mm256_extracti128_si256(values, 1);
+#ifdef AS_INTEGER_COSTS
+		_mm_storeu_si128((__m128i*)(second + k), seconds);
+#else
+		_mm256_storeu_pd(second + k, _mm256_cvtepi32_pd(seconds));
+#endif
+		max_abs = _mm256_max_epi32(max_abs, _mm256_castsi128_si256(_mm_abs_epi32(seconds)));
+	}
+	_mm_storeu_si128((__m128i*)lanes, _mm256_castsi256_si128(max_abs));
+	result = Swap_endianness_pairs(pairs + 2 * k, first + k, second + k, count - k);
+	for(int l = 0; l < 4; ++l)
+		if (lanes[l] > result) result = lanes[l];
+	return result;
+}
+#endif
+
+// Map the file in 'file_path' into memory, returning its address and its size in bytes by reference in 'size'.
+// The mapping is private: it can be written, but the changes are copied on write and never reach the file.
+// Returns NULL if the file can not be opened or mapped.
+void		*Map_file(const char *file_path, long int *size)
+{
+	struct stat	file_stat;
+	void		*address = NULL;
+	int			file_descriptor = open(file_path, O_RDONLY);
+	
+	*size = 0;
+	if (file_descriptor < 0) return NULL;
+	if (fstat(file_descriptor, &file_stat) == 0 && file_stat.st_size > 0)
+	{
+		address = mmap(NULL, file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file_descriptor, 0);
+		if (address == MAP_FAILED) address = NULL;
+		else *size = file_stat.st_size;
+	}
+	// The mapping stays valid after closing the file.
+	close(file_descriptor);
+	return address;
+}
+
+// Wall-clock time in seconds from an arbitrary fixed point (monotonic, so it does not jump with the system clock).
+// All the times of the solver are differences of two calls, with the resolution of the clock (nanoseconds on Linux),
+// so they include the system time and the waits of the threads, and they are meaningful for short solves.
+double	Wall_time()
+{
+	struct timespec	now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// CPU time in seconds used by all the threads of the process.
+double	Cpu_time()
+{
+	struct timespec	now;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+//******************************************************************************
+// WBG2 FILE FORMAT
+/*
+	Native binary format that can be used in place once the file is mapped into memory. All the values are
+	little-endian. The file begins with the header below (64 bytes), followed by the 'offsets' array of the
+	graph ('num_persons + 1' int values), the 'neighbors' array ('num_edges' int values) and the 'costs' array
+	('num_edges' values of 'cost_width' bytes). Each array begins at a multiple of 'WBG2_ALIGNMENT' bytes,
+	and the gaps are filled with zeros.
+*/
+
+#define WBG2_MAGIC		"WBG2"
+#define WBG2_VERSION	1
+#define WBG2_ALIGNMENT	64
+
+typedef struct
+{
+	// The characters of 'WBG2_MAGIC' and the version of the format.
+	char		magic[4];
+	int			version;
+	int			num_persons;
+	int			num_objects;
+	long long	num_edges;
+	// The size in bytes of each cost: '4' for 32 bits integers and '8' for 'double'.
+	int			cost_width;
+	// '1' if every person is adjacent to all the objects in increasing order (see 'Graph_Check_dense').
+	int			is_dense;
+	long long	max_abs_cost;
+	char		reserved[24];
+} Wbg2_Header;
+
+// Position in bytes of each array of a '.wbg2' file with the sizes given in 'header'.
+long int	Wbg2_Offsets_position(const Wbg2_Header *header)
 {
-	struct tms timer;
-	times(&timer);
-	return timer.tms_utime;
+	// The offsets come right after the header, whatever the sizes.
+	(void)header;
+	return sizeof(Wbg2_Header);
+}
+
+long int	Wbg2_Neighbors_position(const Wbg2_Header *header)
+{
+	long int	end = Wbg2_Offsets_position(header) + ((long int)header->num_persons + 1) * sizeof(int);
+	return (end + WBG2_ALIGNMENT - 1) / WBG2_ALIGNMENT * WBG2_ALIGNMENT;
+}
+
+long int	Wbg2_Costs_position(const Wbg2_Header *header)
+{
+	long int	end = Wbg2_Neighbors_position(header) + header->num_edges * sizeof(int);
+	return (end + WBG2_ALIGNMENT - 1) / WBG2_ALIGNMENT * WBG2_ALIGNMENT;
 }
 
 //******************************************************************************
 // AUCTIONSOLVER STRUCTURE
+
+// The adaptive schedule of epsilon (see 'adaptive_epsilon') divides epsilon by a factor between these two values.
+#define AS_MIN_SCALING_FACTOR	2.0
+#define AS_MAX_SCALING_FACTOR	64.0
+// The factor is doubled after a phase with at most this number of bids per unmatched person at its beginning, and
+// halved after a phase with at least the second one.
+#define AS_FEW_BIDS_PER_PERSON	3
+#define AS_MANY_BIDS_PER_PERSON	10
+
+#ifdef AS_STATS
+// Number of buckets of the histogram of the price increments: the bucket 'b' counts the increments 'gamma + epsilon'
+// in [2^b epsilon, 2^(b+1) epsilon), and the last one also the bigger increments.
+#define AS_STATS_BUCKETS	32
+
+// The statistics of a scaling phase, only recorded when compiled with 'AS_STATS' (the statements in 'AS_STAT' are
+// removed otherwise, so they cost nothing).
+typedef struct
+{
+	// The number of matched persons (or objects in the reverse auction) that lost their mate to a bid.
+	long int	evictions;
+	// The number of elements of the adjacency lists scanned by the bids.
+	long int	neighbors_scanned;
+	// The histogram of the price increments of the bids that changed a price.
+	long int	increments[AS_STATS_BUCKETS];
+	// The CPU time (of all the threads) of the phase, in seconds.
+	double		cpu_time;
+} AS_Stats;
+
+#define AS_STAT(statement)	statement
+#else
+#define AS_STAT(statement)
+#endif
+
+// The trace of a scaling phase of the auction.
+typedef struct
+{
+	// The epsilon of the phase, in units of the costs.
+	double		epsilon;
+	// The number of unmatched persons at the beginning of the phase, and the number of bids (of persons, or of objects
+	// in the reverse auction) done in it.
+	int			unmatched;
+	long int	bids;
+	// The duality gap at the end of the phase, in units of the costs. Only computed by the adaptive schedule, '-1' otherwise.
+	double		duality_gap;
+	// The wall-clock time of the phase, in seconds.
+	double		wall_time;
+#ifdef AS_STATS
+	AS_Stats	stats;
+#endif
+} AS_Phase;
+
+// The wall-clock times in seconds of the steps of the last load and of the last solve of a solver (see 'Wall_time').
+// The time of each scaling phase is in its trace ('Phases').
+typedef struct
+{
+	// Reading or copying the graph ('AS_Load_*', 'AS_Set_graph' and 'AS_Set_matrix').
+	double		load_time;
+	// The reductions of the presolve, only done by 'PS_Solve' (see "presolve.h"), '0' otherwise.
+	double		presolve_time;
+	// Making room in the arrays, the feasibility check, the graph of the objects, the packed edges and the start of the
+	// threads (see 'AS_Prepare_solve').
+	double		prepare_time;
+	// All the scaling phases.
+	double		phases_time;
+	// Getting the result from the last phase: the last step of the problems with unmatched objects and the matching cost
+	// (with the presolve, the mapping of the matchings of the components back to the graph).
+	double		extraction_time;
+	// Writing the matching with 'AS_Save_matching_Text'.
+	double		output_time;
+} AS_Timings;
+
 /*
 	Structure that contains all data related to an instance of the Assignment Problem
 	and the data related to the Auction Algorithm.
@@ -60,23 +299,175 @@ typedef struct
 	int				num_objects;
 	// The maximum absolut cost.
 	int				max_abs_cost;
-	// The graph, i.e. the array of persons and their adjancency lists.
+	// The graph, i.e. the adjancency lists of the persons in CSR format.
 	Graph			Persons;
 	
 // DATA RELATED TO THE AUCTION ALGORITHM.
-	// The solving time in seconds.
+	// The solving time in seconds: the wall-clock time of the scaling phases and of the extraction of the result.
 	double			solving_time;
+	// The times of each step of the last load and of the last solve.
+	AS_Timings		Timings;
+	// The size of a maximum cardinality matching of the graph, found by the feasibility check of 'AS_Solve_Instance'
+	// ('-1' if the check was not done).
+	int				max_cardinality;
 	// The cost of the resulting matching after solving the instance.
 	long int		matching_cost;
+	// '1' if 'Prices' and 'Matching' are the solution of the current graph, up to the changes of its edges done since,
+	// so that 'AS_Resolve_Instance' can start from them.
+	int				is_solved;
 	// The array of prices of the objects.
-	double			*Prices;
-	// The array of mates of the objects: object 'i' is matched to person 'Matching[i]'.
+	priceType		*Prices;
+	// The prices are in units of '1 / price_scale' of a cost: the reduced cost of an edge is 'price_scale * cost - price'.
+	// It is 'num_persons + 1' in integer mode (see "types.h") and '1' otherwise.
+	priceType		price_scale;
+	// The array of mates of the objects: object 'i' is matched to person 'Matching[i]', or it is UNMATCHED. After the
+	// real objects come the dummy objects, if there are (see 'num_dummies').
 	int				*Matching;
 	// The array of costs of the matching edges: cost of edge between object 'i' and 
 	// its mate 'Matching[i]' is Matching_costs[i].
 	costType		*Matching_costs;
 	// Deque for storing the unmatched persons.
 	BoundedDeque	Unmatched_persons;
+	// Heap of the unmatched persons of the sequential auction with the priority policies, only allocated with
+	// them (see 'queue_policy'). It is filled from 'Unmatched_persons' at the beginning of each phase.
+	BinaryHeap		Unmatched_heap;
+	// The number of dummy objects, adjacent to every person with cost '0', that take the persons that can not be
+	// matched when there are more persons than objects or in the maximum cardinality mode (see 'maximum_cardinality').
+	// They are the objects 'num_objects, ..., num_objects + num_dummies - 1' of the arrays of the objects, and the
+	// persons matched to them are unmatched in the result.
+	int				num_dummies;
+	// Heap of the dummy objects with their reduced costs '-Prices[j]' as keys, which are the same for all the persons.
+	BinaryHeap		Dummy_heap;
+	
+// DATA RELATED TO THE PARALLEL (JACOBI) AUCTION, only allocated when 'num_threads > 1'.
+	// The persons that bid in the current round, and for each of them the object they bid for,
+	// the new price they offer and the cost of the edge with that object. The bids for the dummy objects do not offer
+	// a price, they keep the best reduced cost of the real objects of the person instead (see 'AS_Assign_dummy_bid').
+	int				*Bidders;
+	int				*Bid_objects;
+	priceType		*Bid_prices;
+	costType		*Bid_costs;
+	// For each object, the index in 'Bidders' of the best bid it received in the current round, or -1.
+	int				*Best_bids;
+	// The threads that compute the bids.
+	ThreadPool		Workers;
+	// The placement of the threads and of the memory on the NUMA nodes, only done when 'numa_placement' is '1' (see
+	// 'AS_Place_memory'), and the costs of the graph it placed last, to copy the graph again only when it is replaced.
+	NumaPlacement	Placement;
+	const costType	*Placed_costs;
+	
+// DATA RELATED TO THE COMBINED FORWARD/REVERSE AUCTION, only allocated when 'reverse_switch > 0'.
+	// The graph seen from the objects, i.e. the adjacency lists of the objects.
+	Graph			Objects;
+	// The array of profits of the persons. The reverse auction works with them as the forward auction
+	// works with the prices: the reduced cost of an edge seen from its object is 'price_scale * cost - Profits[i]'.
+	// For every matched pair 'Profits[i] + Prices[j] = price_scale * cost'.
+	priceType		*Profits;
+	// The array of mates of the persons: person 'i' is matched to object 'Assigned_objects[i]'.
+	int				*Assigned_objects;
+	// Deque for storing the unmatched objects.
+	BoundedDeque	Unmatched_objects;
+	// Flags telling if a person or an object is in its deque of unmatched vertices. A vertex matched by the
+	// auction in the other direction stays in its deque, and is skipped when it gets out of it.
+	char			*Queued_persons;
+	char			*Queued_objects;
+	
+// DATA RELATED TO THE SCAN OF THE ADJACENCY LISTS.
+	// The kernel that finds the best and second best reduced costs, and its 'RC_KERNEL_*' value.
+	// Chosen by 'AS_Solve_Instance' according to the CPU and to the option 'max_kernel'.
+	RC_Scan_function	Scan;
+	int				kernel;
+#ifdef AS_INTEGER_COSTS
+	// The edges of 'Persons' packed in one array, only built when 'packed_edges' is '1' and the graph stores its
+	// neighbors, with room for 'packed_capacity' edges, and the kernel that scans them (see "reducedcosts.h").
+	RC_Packed_edge	*Packed_edges;
+	long int		packed_capacity;
+	RC_Scan_packed_function	Scan_packed;
+#endif
+	
+// DATA RELATED TO THE CANDIDATE CACHE, only allocated when 'candidate_cache >= 2' (see 'AS_Find_best_object_cached').
+	// The positions in the adjacency list of each person of its best 'candidate_cache' objects at its last full scan:
+	// the ones of person 'i' begin at 'Candidates[i * candidates_capacity]'.
+	int				*Candidates;
+	// For each person, the best reduced cost at its last full scan among the objects that are not candidates,
+	// or '-1' in 'Candidates_valid' if the person has to do a full scan.
+	priceType		*Candidates_threshold;
+	char			*Candidates_valid;
+	// The number of candidates per person that fit in 'Candidates'.
+	int				candidates_capacity;
+	
+// DATA RELATED TO THE ORDER OF THE VERTICES, only allocated after 'AS_Reorder_graph'.
+	// The original index of each person and object of the reordered graph, and the index in the reordered graph of
+	// each original person and object. All the other members use the indices of the reordered graph.
+	int				*Person_labels;
+	int				*Object_labels;
+	int				*Person_positions;
+	int				*Object_positions;
+	
+// DATA RELATED TO THE TRACE OF THE SCALING PHASES.
+	// The number of bids done since the solver was created, by all the auctions.
+	long int		num_bids;
+	// The trace of the phases of the last solve: 'num_phases' phases, with room for 'max_phases'.
+	AS_Phase		*Phases;
+	int				num_phases;
+	int				max_phases;
+#ifdef AS_STATS
+	// The statistics of the current phase, copied to its trace at the end of the phase.
+	AS_Stats		Stats;
+#endif
+	
+// DATA RELATED TO THE REUSE OF THE MEMORY BETWEEN SOLVES.
+	// The number of persons and of objects that fit in the arrays of the solver. The arrays only grow, so a solver
+	// can solve many graphs of similar size one after the other without allocating memory (see 'AS_Reserve_memory').
+	int				persons_capacity;
+	int				objects_capacity;
+	// The workspace of the feasibility check (see "hopcroftkarp.h").
+	int				*Feasibility_workspace;
+	
+// OPTIONS OF THE SOLVER. They can be changed after 'AS_Defaults' and before 'AS_Solve_Instance'.
+	// The number of threads used to compute the bids. With one thread the persons bid one at a time
+	// (Gauss-Seidel auction), with more threads all the unmatched persons bid at once (Jacobi auction).
+	int				num_threads;
+	// The fastest kernel that can be used to scan the adjacency lists, one of the 'RC_KERNEL_*' values.
+	// The fastest one supported by the CPU up to this one is used, all of them give the same results.
+	int				max_kernel;
+	// If '1', between scaling phases only the matched pairs that violate the epsilon-CS condition for the
+	// new epsilon are discarded, instead of the whole matching (warm start).
+	int				warm_start;
+	// If greater than zero, the combined forward/reverse auction is used: persons bid for objects (forward) and
+	// objects bid for persons (reverse), and the direction changes each time this number of new pairs is matched.
+	// If zero, only the forward auction is used. The combined auction does not use the threads.
+	int				reverse_switch;
+	// If '1', 'AS_Solve_Instance' first checks with the Hopcroft-Karp algorithm that the graph has a perfect matching,
+	// and returns an error if it does not, since the auction would never end.
+	int				check_feasibility;
+	// If '1', the factor that divides epsilon changes after each phase according to its number of bids: it grows after
+	// cheap phases and shrinks after price wars, starting from 'alpha'. Besides, the solve ends as soon as the duality
+	// gap proves that the matching is optimal (when the costs are integers).
+	int				adaptive_epsilon;
+	// If at least '2', each person keeps this number of best objects of its last full scan (up to 'AS_MAX_CANDIDATES'),
+	// and its bids only look at them while they provably contain its best and second best objects. Only used by the
+	// persons with more than twice this number of neighbors, and not by the combined forward/reverse auction.
+	int				candidate_cache;
+	// The order in which the unmatched persons bid in the sequential auction, one of the 'AS_QUEUE_*' values:
+	// - AS_QUEUE_LIFO: the last person that became unmatched bids first.
+	// - AS_QUEUE_FIFO: the persons bid in the order in which they became unmatched.
+	// - AS_QUEUE_EVICTED_FIRST: the persons bid in order, except that an evicted person bids right away.
+	// - AS_QUEUE_PRICE: the persons evicted from the objects with the lowest prices (the most contested ones) bid first.
+	// - AS_QUEUE_DEGREE: the persons with the fewest neighbors bid first.
+	// The parallel and the forward/reverse auctions ignore it.
+	int				queue_policy;
+	// If '1', in integer mode the scan of the adjacency lists reads a copy of the edges where each neighbor and its cost
+	// are packed in a 64 bits word, i.e. one stream instead of two, at the price of that copy. It is ignored with 'double'
+	// costs and by dense graphs, which already read the costs as one stream.
+	int				packed_edges;
+	// If '1', the solver finds a matching of minimum cost among the ones of maximum cardinality, instead of requiring
+	// a matching that covers all the persons (or all the objects, when there are more persons than objects).
+	int				maximum_cardinality;
+	// If '1', the parallel auction pins its threads to the CPUs of the NUMA nodes, copies the graph so that the adjacency
+	// lists of each range of persons are in the memory of the node of one thread, and interleaves the prices over the
+	// nodes (see 'AS_Place_memory'). It is ignored with one thread.
+	int				numa_placement;
 } AuctionSolver;
 
 //******************************************************************************
@@ -89,450 +480,2741 @@ void	AS_Defaults(AuctionSolver *Instance)
 	Instance->num_persons = 0;
 	Instance->num_objects = 0;
 	Instance->matching_cost = 0;
+	Instance->is_solved = 0;
 	Instance->solving_time = 0;
+	memset(&Instance->Timings, 0, sizeof(AS_Timings));
 	Instance->max_abs_cost = 0;
+	Instance->max_cardinality = -1;
 	Instance->Prices = NULL;
+	Instance->price_scale = 1;
 	Instance->Matching = NULL;
 	Instance->Matching_costs = NULL;
-	Instance->Persons = NULL;
+	Graph_Defaults(&Instance->Persons);
 	BD_Defaults(&Instance->Unmatched_persons);
+	BH_Defaults(&Instance->Unmatched_heap);
+	Instance->num_dummies = 0;
+	BH_Defaults(&Instance->Dummy_heap);
+	Instance->Bidders = NULL;
+	Instance->Bid_objects = NULL;
+	Instance->Bid_prices = NULL;
+	Instance->Bid_costs = NULL;
+	Instance->Best_bids = NULL;
+	TP_Defaults(&Instance->Workers);
+	NP_Defaults(&Instance->Placement);
+	Instance->Placed_costs = NULL;
+	Graph_Defaults(&Instance->Objects);
+	Instance->Profits = NULL;
+	Instance->Assigned_objects = NULL;
+	BD_Defaults(&Instance->Unmatched_objects);
+	Instance->Queued_persons = NULL;
+	Instance->Queued_objects = NULL;
+	Instance->Scan = RC_Scan_scalar;
+	Instance->kernel = RC_KERNEL_SCALAR;
+#ifdef AS_INTEGER_COSTS
+	Instance->Packed_edges = NULL;
+	Instance->packed_capacity = 0;
+	Instance->Scan_packed = RC_Scan_packed_scalar;
+#endif
+	Instance->num_bids = 0;
+	Instance->Phases = NULL;
+	Instance->num_phases = 0;
+	Instance->max_phases = 0;
+	Instance->persons_capacity = 0;
+	Instance->objects_capacity = 0;
+	Instance->Feasibility_workspace = NULL;
+	Instance->Candidates = NULL;
+	Instance->Candidates_threshold = NULL;
+	Instance->Candidates_valid = NULL;
+	Instance->candidates_capacity = 0;
+	Instance->num_threads = 1;
+	Instance->max_kernel = RC_KERNEL_AVX512;
+	Instance->warm_start = 0;
+	Instance->reverse_switch = 0;
+	Instance->check_feasibility = 1;
+	Instance->adaptive_epsilon = 0;
+	Instance->candidate_cache = 0;
+	Instance->queue_policy = AS_QUEUE_LIFO;
+	Instance->packed_edges = 0;
+	Instance->maximum_cardinality = 0;
+	Instance->numa_placement = 0;
+	Instance->Person_labels = NULL;
+	Instance->Object_labels = NULL;
+	Instance->Person_positions = NULL;
+	Instance->Object_positions = NULL;
+}
+
+// Forget the order of the vertices of 'AS_Reorder_graph', when the graph is replaced.
+void	AS_Clear_order(AuctionSolver *Instance)
+{
+	Delete_array((char**)&Instance->Person_labels);
+	Delete_array((char**)&Instance->Object_labels);
+	Delete_array((char**)&Instance->Person_positions);
+	Delete_array((char**)&Instance->Object_positions);
 }
 
 // Safe destructor: free the memory and set everything to default values.
 void	AS_Clear(AuctionSolver *Instance)
 {
-	Graph_Clear(&Instance->Persons, Instance->num_persons);
+	Graph_Clear(&Instance->Persons);
 	Delete_array((char**)&Instance->Prices);
 	Delete_array((char**)&Instance->Matching);
 	Delete_array((char**)&Instance->Matching_costs);
 	BD_Clear(&Instance->Unmatched_persons);
+	BH_Clear(&Instance->Unmatched_heap);
+	Instance->num_dummies = 0;
+	BH_Clear(&Instance->Dummy_heap);
+	Delete_array((char**)&Instance->Bidders);
+	Delete_array((char**)&Instance->Bid_objects);
+	Delete_array((char**)&Instance->Bid_prices);
+	Delete_array((char**)&Instance->Bid_costs);
+	Delete_array((char**)&Instance->Best_bids);
+	TP_Clear(&Instance->Workers);
+	NP_Clear(&Instance->Placement);
+	Instance->Placed_costs = NULL;
+	Graph_Clear(&Instance->Objects);
+	Delete_array((char**)&Instance->Profits);
+	Delete_array((char**)&Instance->Assigned_objects);
+	BD_Clear(&Instance->Unmatched_objects);
+	Delete_array((char**)&Instance->Queued_persons);
+	Delete_array((char**)&Instance->Queued_objects);
+#ifdef AS_INTEGER_COSTS
+	Delete_array((char**)&Instance->Packed_edges);
+	Instance->packed_capacity = 0;
+#endif
+	Delete_array((char**)&Instance->Feasibility_workspace);
+	Delete_array((char**)&Instance->Candidates);
+	Delete_array((char**)&Instance->Candidates_threshold);
+	Delete_array((char**)&Instance->Candidates_valid);
+	Instance->candidates_capacity = 0;
+	AS_Clear_order(Instance);
+	Delete_array((char**)&Instance->Phases);
+	Instance->num_phases = 0;
+	Instance->max_phases = 0;
+	Instance->persons_capacity = 0;
+	Instance->objects_capacity = 0;
 	Instance->num_persons = 0;
 	Instance->num_objects = 0;
 	Instance->matching_cost = 0;
+	Instance->is_solved = 0;
 	Instance->solving_time = 0;
+	memset(&Instance->Timings, 0, sizeof(AS_Timings));
 	Instance->max_abs_cost = 0;
+	Instance->max_cardinality = -1;
 }
 
-// Load a graph from the file in 'file_path' onto the AuctionSolver instance.
-// The file format must be binary.
+// Copy the options of the solver 'Source' (see OPTIONS OF THE SOLVER) to 'Target', to solve other graphs with them.
+void	AS_Copy_options(AuctionSolver *Target, const AuctionSolver *Source)
+{
+	Target->num_threads = Source->num_threads;
+	Target->max_kernel = Source->max_kernel;
+	Target->warm_start = Source->warm_start;
+	Target->reverse_switch = Source->reverse_switch;
+	Target->check_feasibility = Source->check_feasibility;
+	Target->adaptive_epsilon = Source->adaptive_epsilon;
+	Target->candidate_cache = Source->candidate_cache;
+	Target->queue_policy = Source->queue_policy;
+	Target->packed_edges = Source->packed_edges;
+	Target->maximum_cardinality = Source->maximum_cardinality;
+	Target->numa_placement = Source->numa_placement;
+}
+
+// Read a graph in binary format (see 'AS_Load_graph_Binary') onto the AuctionSolver instance from the 'num_values' int
+// values of 'data', beginning at 'data[*position]'. The position is moved to the end of the graph.
+// A first pass over the numbers of neighbors gives the beginning of each adjacency list, and a second pass swaps the bytes
+// of the edges straight into the graph.
 // The members that will be modified are: 'num_persons, num_objects, max_abs_cost, Persons'.
-Error	AS_Load_graph_Binary(AuctionSolver *Instance, char *file_path)
+Error	AS_Read_graph_Binary(AuctionSolver *Instance, const int *data, long int num_values, long int *position)
 {
 	Error		error = {0, ""};
-	FILE		*graph_file;
-	int			size_int = sizeof(int);
+	// The position of the next value to read.
+	long int	next = *position;
 	int			num_neighbors;
-	int			neighbor;
-	int			cost;
-	
+	int			num_edges = 0;
+	int			max_abs = 0;
+	// The function that swaps the bytes of the edges.
+	int			(*Swap_pairs)(const int*, int*, costType*, int) = Swap_endianness_pairs;
 	
-	// Open the graph file and check for errors.
-	graph_file = fopen(file_path, "rb");
-	if(graph_file == 0) printf("\nGraph file does not exists: '%s'\n", file_path);
 	
 	// Get the number of persons and the number of objects of the graph.
-	fread(&Instance->num_persons, size_int, 1, graph_file);
-	Swap_endianness_int(&Instance->num_persons);
-	fread(&Instance->num_objects, size_int, 1, graph_file);
-	Swap_endianness_int(&Instance->num_objects);
+	Instance->is_solved = 0;
+	AS_Clear_order(Instance);
+	Instance->max_abs_cost = 0;
+	Instance->num_persons = (num_values - next >= 2 ? (int)__builtin_bswap32((unsigned)data[next]) : -1);
+	Instance->num_objects = (num_values - next >= 2 ? (int)__builtin_bswap32((unsigned)data[next + 1]) : -1);
+	
+	// First pass: count the edges, checking that every adjacency list fits in the data.
+	next += 2;
+	for(int person_i = 0; person_i < Instance->num_persons && next <= num_values; ++person_i)
+	{
+		num_neighbors = (next < num_values ? (int)__builtin_bswap32((unsigned)data[next]) : -1);
+		if (num_neighbors < 0)
+		{
+			next = num_values + 1;
+			break;
+		}
+		next += 1 + 2 * (long int)num_neighbors;
+		num_edges += num_neighbors;
+	}
+	if (Instance->num_persons < 0 || Instance->num_objects < 0 || next > num_values)
+	{
+		Instance->num_persons = 0;
+		Instance->num_objects = 0;
+		Error_Set(&error, -1, "Error: corrupted graph file in 'AS_Read_graph_Binary'");
+		return error;
+	}
 	
-	// Make the allocation of the memory. Initialized to zero for safe clear in case of future memory allocation error.
-	Graph_Allocate(&Instance->Persons, Instance->num_persons);
-	if (Instance->Persons == NULL)
+	// Make the allocation of the memory.
+	error = Graph_Allocate(&Instance->Persons, Instance->num_persons, num_edges);
+	if (error.code == -1)
 	{
 		Instance->num_persons = 0;
 		Instance->num_objects = 0;
-		Error_Set(&error, -1, "Error: no memory for the allocation of a person in 'AS_Load_graph_Binary'");
+		strcat(error.msg, " In 'AS_Read_graph_Binary'");
 		return error;
 	}
 	
-	// Load the arcs.
+#ifdef RC_X86_KERNELS
+	if (__builtin_cpu_supports("avx2")) Swap_pairs = Swap_endianness_pairs_avx2;
+#endif
+	
+	// Second pass: fill the neighbors and costs arrays of each person.
+	next = *position + 2;
+	num_edges = 0;
 	for(int person_i = 0; person_i < Instance->num_persons; ++person_i)
 	{
-		// Read the number of neighbors of the person.
-		fread(&num_neighbors, size_int, 1, graph_file);
-		Swap_endianness_int(&num_neighbors);
-		// Try to allocate memory for the Person and check for errors.
-		error = Person_Allocate(&Instance->Persons[person_i], num_neighbors);
-		if (error.code == -1)
-		{
-			AS_Clear(Instance);
-			strcat(error.msg, " In 'AS_Load_graph_Binary'");
-			return error;
-		}
+		num_neighbors = (int)__builtin_bswap32((unsigned)data[next]);
+		Instance->Persons.offsets[person_i] = num_edges;
+		max_abs = Swap_pairs(data + next + 1, Instance->Persons.neighbors + num_edges,
+			Instance->Persons.costs + num_edges, num_neighbors);
 		
-		// Fill the neighbors and costs arrays of the person.
-		for(int neighbor_j = 0; neighbor_j < num_neighbors; ++neighbor_j)
-		{
-			// Get the neighbor index and the edge cost.
-			fread(&neighbor, size_int, 1, graph_file);
-			Swap_endianness_int(&neighbor);
-			fread(&cost, size_int, 1, graph_file);
-			Swap_endianness_int(&cost);
-			// Put them in the respective arrays.
-			Instance->Persons[person_i].neighbors[neighbor_j] = neighbor;
-			Instance->Persons[person_i].costs[neighbor_j] = (costType)cost;
-			
-			// Update the maximum absolute cost.
-			if ((int)abs(cost) > Instance->max_abs_cost) Instance->max_abs_cost = (int)abs(cost);
-		}
+		// Update the maximum absolute cost.
+		if (max_abs > Instance->max_abs_cost) Instance->max_abs_cost = max_abs;
+		next += 1 + 2 * (long int)num_neighbors;
+		num_edges += num_neighbors;
 	}
-	
-	fclose(graph_file);
+	Graph_Check_dense(&Instance->Persons, Instance->num_objects);
+	*position = next;
 	
 	Error_Set(&error, 1, "OK");
 	return error;
 }
 
 // Load a graph from the file in 'file_path' onto the AuctionSolver instance.
-// The file format must be text.
+// The file format must be binary.
+// The file is mapped into memory and parsed in place by 'AS_Read_graph_Binary'.
 // The members that will be modified are: 'num_persons, num_objects, max_abs_cost, Persons'.
-Error	AS_Load_graph_Text(AuctionSolver *Instance, char *file_path)
+Error	AS_Load_graph_Binary(AuctionSolver *Instance, char *file_path)
 {
-	Error		error;
-	FILE		*graph_file;
-	char		line[200];
-	char		aux_str[100];
-	int			*aux_neighbors = NULL;
-	costType	*aux_costs = NULL;
-	// The index of a person, of an object and the cost between them.
-	int			person_i;
-	int			object_j;
-	int			cost;
-	// For counting the number of neighbors of a person.
-	int			num_neighbors;
-	// To detect when we have reached the adjacency list of a different person.
-	int			aux_person;
-	
-	
-	// For safe string processing.
-	for (int i = 0; i < 200; ++i) line[i] = '\0';
-	for (int i = 0; i < 100; ++i) aux_str[i] = '\0';
-	
-	// Open the text file.
-	graph_file = fopen(file_path, "r");
+	Error		error = {0, ""};
+	int			*file_data = NULL;
+	long int	file_size = 0;
+	long int	position = 0;
+	double		start_time = Wall_time();
 	
-	// Read the number of persons and the number of objects.
-	fgets(line, 200, graph_file);
-	sscanf(line, "%s %d", aux_str, &Instance->num_persons);
-	fgets(line, 200, graph_file);
-	sscanf(line, "%s %d", aux_str, &Instance->num_objects);
 	
-	// Make the allocation of the memory. Initialized to zero for safe clear in case of future memory allocation error.
-	Graph_Allocate(&Instance->Persons, Instance->num_persons);
-	if (Instance->Persons == NULL)
+	// Map the graph file and check for errors.
+	file_data = (int*) Map_file(file_path, &file_size);
+	if (file_data == NULL)
 	{
-		Instance->num_persons = 0;
-		Instance->num_objects = 0;
-		Error_Set(&error, -1, "Error: no memory for the allocation of a person in 'AS_Load_graph_Text'");
+		Error_Set(&error, -1, "Error: the graph file does not exist or is empty, in 'AS_Load_graph_Binary'");
 		return error;
 	}
+	madvise(file_data, file_size, MADV_SEQUENTIAL);
 	
-	// Allocate auxiliary space for an adjacency list.
-	Allocate_array((char**)&aux_neighbors, Instance->num_objects * sizeof(int));
-	Allocate_array((char**)&aux_costs, Instance->num_objects * sizeof(costType));
-	if (aux_neighbors ==  NULL || aux_costs == NULL)
-	{
-		AS_Clear(Instance);
-		Delete_array((char**) aux_neighbors);
-		Delete_array((char**) aux_costs);
-		Error_Set(&error, -1, "Error: no memory for the allocation of a person in 'AS_Load_graph_Text'");
-		return error;
-	}
-	
-	// Work apart the first line (edge).
-	fgets(line, 200, graph_file);
-	for(int i = 0; line[i] != '\0'; ++i)
-		if (line[i] == ',' || line[i] == '\r' || line[i] == '\n') line[i] = ' ';
-	sscanf(line, "%d %d %d", &person_i, &object_j, &cost);
-	aux_neighbors[0] = object_j;
-	aux_costs[0] = cost;
-	
-	num_neighbors = 1;
-	aux_person = person_i;
-	// Read line by line (i.e. edge by edge).
-	// We will read one adjacency list at a time in 'aux_neighbors' and 'aux_costs' and dump it in the corresponding person.
-	while(fgets(line, 200, graph_file) != NULL)
-	{
-		// From the line get the person index, the object index, and the edge cost.
-		for(int i = 0; line[i] != '\0'; ++i)
-			if (line[i] == ',' || line[i] == '\r' || line[i] == '\n') line[i] = ' ';
-		sscanf(line, "%d %d %d", &person_i, &object_j, &cost);
-		
-		// If we have reached the adjacency list of a different person, save the current one and start the next.
-		if (aux_person != person_i)
-		{
-			// Since we now know the size of the adjacency list, allocate space.
-			error = Person_Allocate(&Instance->Persons[aux_person], num_neighbors);
-			if (error.code == -1)
-			{
-				AS_Clear(Instance);
-				strcat(error.msg, " In 'AS_Load_graph_Text'");
-				return error;
-			}
-			// Dump the current adjacency list into the person 'person_i'.
-			for (int neighbor_j = 0; neighbor_j < num_neighbors; ++neighbor_j)
-			{
-				Instance->Persons[aux_person].neighbors[neighbor_j] = aux_neighbors[neighbor_j];
-				Instance->Persons[aux_person].costs[neighbor_j] = aux_costs[neighbor_j];
-			}
-			
-			aux_person = person_i;
-			num_neighbors = 0;
-		}
-		
-		aux_neighbors[num_neighbors] = object_j;
-		aux_costs[num_neighbors] = (costType) cost;
-		++num_neighbors;
-	}
-	// The last person wont be created inside the loop, so we create it here.
-	error = Person_Allocate(&Instance->Persons[aux_person], num_neighbors);
-	if (error.code == -1)
-	{
-		AS_Clear(Instance);
-		strcat(error.msg, " In 'AS_Load_graph_Text'");
-		return error;
-	}
-	for (int neighbor_j = 0; neighbor_j < num_neighbors; ++neighbor_j)
-	{
-		Instance->Persons[aux_person].neighbors[neighbor_j] = aux_neighbors[neighbor_j];
-		Instance->Persons[aux_person].costs[neighbor_j] = aux_costs[neighbor_j];
-	}
+	error = AS_Read_graph_Binary(Instance, file_data, file_size / sizeof(int), &position);
+	if (error.code == -1) strcat(error.msg, " In 'AS_Load_graph_Binary'");
+	munmap(file_data, file_size);
 	
-	// Free the auxiliary adjacency list.
-	Delete_array((char**) &aux_neighbors);
-	Delete_array((char**) &aux_costs);
-	fclose(graph_file);
+	Instance->Timings.load_time = Wall_time() - start_time;
+	return error;
 }
 
-// Save the resulting matching and its cost to a text file.
-void	AS_Save_matching_Text(AuctionSolver *Instance, char *file_path)
+// Parse the integer (with an optional sign) that begins at 'text[*position]', skipping the spaces, tabs and commas
+// before it, but not the ends of line. The text ends at 'text[end]'. Returns '1' if there is an integer, and then
+// its value is in 'value' and 'position' is moved after it.
+int		Parse_int(const char *text, long int end, long int *position, int *value)
 {
-	FILE	*output_file;
-	
-	// Save the matching cost and the solving time.
-	output_file = fopen(file_path, "w");
-	fprintf(output_file, "cost %.0f\n", (double)Instance->matching_cost);
-	fprintf(output_file, "time %f\n", Instance->solving_time);
-	// Save the matching edge by edge, space separated as: "person_index object_index cost"
-	for (int object_i = 0; object_i < Instance->num_objects; ++object_i)
-		fprintf(output_file, "%d,%d,%.0lf\n", Instance->Matching[object_i], object_i, Instance->Matching_costs[object_i]);
+	long int	k = *position;
+	int			negative = 0;
+	int			result = 0;
 	
-	fclose(output_file);
+	while(k < end && (text[k] == ' ' || text[k] == '\t' || text[k] == ',' || text[k] == '\r' || text[k] == '\v' || text[k] == '\f')) ++k;
+	if (k < end && (text[k] == '-' || text[k] == '+')) negative = (text[k++] == '-');
+	if (k == end || text[k] < '0' || text[k] > '9') return 0;
+	while(k < end && text[k] >= '0' && text[k] <= '9') result = 10 * result + (text[k++] - '0');
+	*value = (negative ? -result : result);
+	*position = k;
+	return 1;
 }
 
-// Displays the graph contained in the 'AuctionSolver' instance.
-// It shows the number of persons and objects; and the adjacency lists of the persons as
-// pairs (neighbor, cost).
-// Only use on very small instances, to see that the instance is being loaded correctly.
-void	AS_Display_Instance(AuctionSolver *Instance)
+// Position of the beginning of the line after the one that contains 'text[position]', or 'end' if it is the last line.
+long int	Next_line(const char *text, long int end, long int position)
 {
-	int			num_neighbors;
-	int			neighbor;
-	costType	cost;
+	const char	*new_line = (position < end ? (const char*) memchr(text + position, '\n', end - position) : NULL);
 	
-	printf("------------------------------------------------------------\n");
-	printf("Num_Persons=%d, Num_Objects=%d\n", Instance->num_objects, Instance->num_objects);
-	for(int person_i = 0; person_i < Instance->num_persons; ++person_i)
-	{
-		num_neighbors = Instance->Persons[person_i].num_neighbors;
-		printf("--------------\n");
-		printf("Num_Neighbors of p%d:%d\n", person_i, num_neighbors);
-		for(int neighbor_j = 0; neighbor_j < num_neighbors; ++neighbor_j)
-		{
-			neighbor = Instance->Persons[person_i].neighbors[neighbor_j];
-			cost = Instance->Persons[person_i].costs[neighbor_j];
-			printf("(%d,%d) ", neighbor, (int)cost);
-		}
-		printf("\n");
-	}
-	printf("------------------------------------------------------------\n");
+	return (new_line == NULL ? end : new_line - text + 1);
 }
 
-// Given the index 'I' of an unmatched person, this function finds the index of the object that has the best_reduced_cost,
-// the edge cost with this object, and the value of 'gamma' which is the difference 'second_best_reduced_cost - best_reduced_cost'.
-// The first is returned as a regular return value and the other two are returned by reference.
-int		AS_Find_best_object(AuctionSolver *Instance, int I, double *gamma, costType *cost_of_best_object)
+// Argument of the tasks that parse the edges of a text graph file. The edges begin at 'text[parts[0]]' and
+// thread 't' parses the lines that begin in the positions {parts[t], ..., parts[t + 1] - 1}.
+typedef struct
 {
-	//The smallest and the second smallest losses with very big values.
-	double		best_reduced_cost = _INFINITY;
-	double		second_best_reduced_cost = _INFINITY;
-	double		auxiliary_reduced_cost = _INFINITY;
+	AuctionSolver	*Instance;
+	const char		*text;
+	long int		*parts;
+	// The array 'Part_edges[t]' of thread 't' has an element for each of the persons {Part_first[t], ...,
+	// Part_first[t] + Part_size[t] - 1}, the range of the persons found by the thread, so the arrays of all the threads
+	// take about 'num_persons' elements when the file is grouped by person. In the first pass it counts the edges of
+	// each person found by the thread, and in the second pass it has the position of the next one.
+	int				**Part_edges;
+	int				*Part_first;
+	int				*Part_size;
+	// '0' in the first pass (count the edges) and '1' in the second one (place them in the graph).
+	int				place_edges;
+	// For each thread: the maximum absolute cost it found, '1' if it found an index out of range, and '1' if there was
+	// no memory to count its edges.
+	int				*max_abs;
+	int				*out_of_range;
+	int				*no_memory;
+} AS_Text_task_arg;
+
+// Make the range of persons of the thread 'thread_i' (see 'AS_Text_task_arg') contain the person 'person_i'. The range
+// grows at least by its size, or by 64 persons, so that the counts are copied only a few times.
+// Returns '0' if there is no memory for the new range.
+int		AS_Cover_person(AS_Text_task_arg *task_arg, int thread_i, int person_i)
+{
+	long int	first = task_arg->Part_first[thread_i];
+	long int	size = task_arg->Part_size[thread_i];
+	long int	growth = (size > 64 ? size : 64);
+	long int	new_first = first;
+	long int	new_last = first + size;
+	int			*counts;
 	
-	//The variable we will return.
-	int			best_object = UNMATCHED;
-	//Pointer to the person "I".
-	Person*		person_ptr = Instance->Persons + I;
+	if (person_i >= first && person_i < first + size) return 1;
+	if (size == 0) new_first = new_last = person_i;
+	if (person_i < new_first) new_first = (person_i < new_first - growth ? person_i : new_first - growth);
+	if (person_i >= new_last) new_last = (person_i + 1 > new_last + growth ? person_i + 1 : new_last + growth);
+	if (new_first < 0) new_first = 0;
+	if (new_last > task_arg->Instance->num_persons) new_last = task_arg->Instance->num_persons;
 	
+	counts = (int*) calloc(new_last - new_first, sizeof(int));
+	if (counts == NULL) return 0;
+	if (size > 0) memcpy(counts + (first - new_first), task_arg->Part_edges[thread_i], size * sizeof(int));
+	free((char*) task_arg->Part_edges[thread_i]);
+	task_arg->Part_edges[thread_i] = counts;
+	task_arg->Part_first[thread_i] = (int)new_first;
+	task_arg->Part_size[thread_i] = (int)(new_last - new_first);
+	return 1;
+}
+
+// Task run by each thread of the pool: parse the edges in its part of the text. A line is an edge if it begins
+// with three integers "person_index object_index cost", separated by spaces or commas, other lines are skipped.
+void	AS_Parse_edges_task(void *arg, int thread_i, int num_threads)
+{
+	AS_Text_task_arg	*task_arg = (AS_Text_task_arg*) arg;
+	AuctionSolver		*Instance = task_arg->Instance;
+	const char			*text = task_arg->text;
+	long int			position = task_arg->parts[thread_i];
+	long int			end = task_arg->parts[thread_i + 1];
+	int					*Person_edges;
+	// The index of a person, of an object and the cost between them.
+	int					person_i;
+	int					object_j;
+	int					cost;
 	
-	//See if the person has only one neighbor.
-	if(person_ptr->num_neighbors == 1)
-	{
-		best_object = person_ptr->neighbors[0];
-		*cost_of_best_object = person_ptr->costs[0];
-		//Assign a value to "best_reduced_cost" so that gamma==1000000.0.
-		best_reduced_cost -= 1000000.0;
-	}
-	else
+	// The parts of the text were split at the line ends by the caller, the number of threads is not needed.
+	(void)num_threads;
+	task_arg->max_abs[thread_i] = 0;
+	task_arg->out_of_range[thread_i] = 0;
+	task_arg->no_memory[thread_i] = 0;
+	while(position < end)
 	{
-		// Find the first two best reduced costs.
-		best_reduced_cost = person_ptr->costs[0] - Instance->Prices[person_ptr->neighbors[0]];
-		auxiliary_reduced_cost = person_ptr->costs[1] - Instance->Prices[person_ptr->neighbors[1]];
-		if (best_reduced_cost <= auxiliary_reduced_cost)
+		if (Parse_int(text, end, &position, &person_i) && Parse_int(text, end, &position, &object_j)
+			&& Parse_int(text, end, &position, &cost))
 		{
-			second_best_reduced_cost = auxiliary_reduced_cost;
-			best_object = person_ptr->neighbors[0];
-			*cost_of_best_object = person_ptr->costs[0];
-		}
-		else
-		{
-			second_best_reduced_cost = best_reduced_cost;
-			best_reduced_cost = auxiliary_reduced_cost;
-			best_object = person_ptr->neighbors[1];
-			*cost_of_best_object = person_ptr->costs[1];
-		}
-		
-		//Scan the rest of neighbours.
-		for(int neighs_i = 2; neighs_i < person_ptr->num_neighbors; ++neighs_i)
-		{
-			//Get the reduced cost of the edge.
-			auxiliary_reduced_cost = person_ptr->costs[neighs_i] - Instance->Prices[person_ptr->neighbors[neighs_i]];
-			
-			//Update the smallest and second smallest reduced costs.
-			if(auxiliary_reduced_cost < best_reduced_cost)
+			if (!task_arg->place_edges)
 			{
-				second_best_reduced_cost = best_reduced_cost;
-				best_reduced_cost = auxiliary_reduced_cost;
-				//Keep track of the best object and its cost.
-				best_object = person_ptr->neighbors[neighs_i];
-				*cost_of_best_object = person_ptr->costs[neighs_i];
+				if (person_i < 0 || person_i >= Instance->num_persons || object_j < 0 || object_j >= Instance->num_objects)
+				{
+					task_arg->out_of_range[thread_i] = 1;
+					return;
+				}
+				if (!AS_Cover_person(task_arg, thread_i, person_i))
+				{
+					task_arg->no_memory[thread_i] = 1;
+					return;
+				}
+				++task_arg->Part_edges[thread_i][person_i - task_arg->Part_first[thread_i]];
+			}
+			else
+			{
+				Person_edges = task_arg->Part_edges[thread_i] + (person_i - task_arg->Part_first[thread_i]);
+				Instance->Persons.neighbors[*Person_edges] = object_j;
+				Instance->Persons.costs[*Person_edges] = (costType) cost;
+				++*Person_edges;
+				
+				// Update the maximum absolute cost.
+				if (abs(cost) > task_arg->max_abs[thread_i]) task_arg->max_abs[thread_i] = abs(cost);
 			}
-			else if(auxiliary_reduced_cost < second_best_reduced_cost)
-				second_best_reduced_cost = auxiliary_reduced_cost;
 		}
+		position = Next_line(text, end, position);
 	}
-	
-	//Compute the bidding difference "gamma".
-	*gamma = second_best_reduced_cost - best_reduced_cost;
-	
-	//Return the index of the best object.
-	return best_object;
 }
 
-// Given 'epsilon', find a matching and prices that satisfy the epsilon-CS condition.
-void	AS_eOpt_Matching(AuctionSolver *Instance, double epsilon)
+// Free the arrays of the tasks that parse a text graph file with 'num_threads' threads.
+void	AS_Free_text_task_arg(AS_Text_task_arg *task_arg, int num_threads)
 {
-	//A person.
-	int			I = 0;
-	//The bidding difference.
-	double		gamma = 0.0;
-	//The best option for a person.
-	int			best_object = 0;
-	//The cost of the best object.
-	costType	cost_of_best_object = 0;
-	
-	//While we have unmatched persons.
-	while(Instance->Unmatched_persons.length > 0)
-	{
-		//Get an unmatched person "I".
-		BD_Pop_Back(&Instance->Unmatched_persons, &I);
-		
-		//Get the best option for person "I", the bidding increment and the cost of the chosen edge.
-		best_object = AS_Find_best_object(Instance, I, &gamma, &cost_of_best_object);
-		
-		//If the chosen object is matched, then insert its matching in the unmatched list.
-		if(Instance->Matching[best_object] != UNMATCHED)
-			BD_Push_Back(&Instance->Unmatched_persons, Instance->Matching[best_object]);
-		
-		//Update the matching and the costs of the matching.
-		Instance->Matching[best_object] = I;
-		Instance->Matching_costs[best_object] = cost_of_best_object;
-		
-		//Update (decrease) the price of the object.
-		Instance->Prices[best_object] -= (gamma + epsilon);
-	}
+	if (task_arg->Part_edges != NULL)
+		for(int thread_i = 0; thread_i < num_threads; ++thread_i) free((char*) task_arg->Part_edges[thread_i]);
+	free((char*) task_arg->Part_edges);
+	free((char*) task_arg->Part_first);
+	free((char*) task_arg->Part_size);
+	free((char*) task_arg->parts);
+	free((char*) task_arg->max_abs);
+	free((char*) task_arg->out_of_range);
+	free((char*) task_arg->no_memory);
 }
 
-// Find a matching and prices that satisfy the epsilon-CS condition with 'epsilon=final_epsilon'.
-// This is done via the Auction Algorithm, with scaling phases that go from 'epsilon=initial_epsilon'
-// down to 'epsilon=final_epsilon', with a scaling factor of 'alpha'.
-Error	AS_Solve_Instance(AuctionSolver *Instance, double initial_epsilon, double alpha, double final_epsilon)
+// Load a graph from the file in 'file_path' onto the AuctionSolver instance.
+// The file format must be text.
+// The file is mapped into memory and its lines are split in equal parts among the 'num_threads' threads of 'Workers'.
+// It is parsed twice: the first pass counts the edges of each person found by each thread, which gives where each thread
+// places the edges of each person, and the second pass places them. The edges of a person keep the order of the file.
+// Each thread only counts the range of persons of its part, so the counts take about 'num_persons' elements when the
+// file is grouped by person, whatever the number of threads.
+// The members that will be modified are: 'num_persons, num_objects, max_abs_cost, Persons'.
+Error	AS_Load_graph_Text(AuctionSolver *Instance, char *file_path)
 {
-	//To get the time.
-	unsigned		start_time;
-	//Error tracker.
-	Error			error = {0, ""};
-	//The epsilon.
-	double			epsilon;
-	int				full_reset = 1;
+	Error				error;
+	AS_Text_task_arg	task_arg;
+	char				*text = NULL;
+	long int			text_size = 0;
+	long int			position = 0;
+	int					num_threads = 1;
+	int					count = 0;
+	int					out_of_range = 0;
+	int					no_memory = 0;
+	int					*counts;
+	double				start_time = Wall_time();
 	
-	//Check for some posible errors.
-	if(Instance->num_persons <= 0 || Instance->num_persons != Instance->num_objects)
+	
+	// Map the text file.
+	text = (char*) Map_file(file_path, &text_size);
+	if (text == NULL)
 	{
-		Error_Set(&error, -1, "Error: The graph can not be empty or unbalanced");
+		Error_Set(&error, -1, "Error: the graph file does not exist or is empty, in 'AS_Load_graph_Text'");
 		return error;
 	}
-	if(initial_epsilon < 0 || final_epsilon < 0)
+	madvise(text, text_size, MADV_SEQUENTIAL);
+	
+	// Read the number of persons and the number of objects, each one in a line after a word.
+	Instance->is_solved = 0;
+	AS_Clear_order(Instance);
+	Instance->max_abs_cost = 0;
+	Instance->num_persons = 0;
+	Instance->num_objects = 0;
+	while(position < text_size && text[position] != ' ' && text[position] != '\t') ++position;
+	Parse_int(text, text_size, &position, &Instance->num_persons);
+	position = Next_line(text, text_size, position);
+	while(position < text_size && text[position] != ' ' && text[position] != '\t') ++position;
+	Parse_int(text, text_size, &position, &Instance->num_objects);
+	position = Next_line(text, text_size, position);
+	if (Instance->num_persons < 0 || Instance->num_objects < 0)
 	{
-		Error_Set(&error, -1, "Error: The initial and final values for epsilon can not be negative.");
+		munmap(text, text_size);
+		Instance->num_persons = 0;
+		Instance->num_objects = 0;
+		Error_Set(&error, -1, "Error: corrupted graph file in 'AS_Load_graph_Text'");
 		return error;
 	}
 	
-	//MEMORY ALLOCATION.
-	//Allocate memory for the price of each object.
-	Allocate_array((char**)&Instance->Prices, Instance->num_objects * sizeof(double));
-	//Allocate memory for the matching vector of the objects.
-	Allocate_array((char**)&Instance->Matching, Instance->num_objects * sizeof(double));
-	//Allocate memory for the cost of the resulting matching.
-	Allocate_array((char**)&Instance->Matching_costs, Instance->num_objects * sizeof(double));
-	//Allocate memory for the unmatched persons list.
-	BD_AllocateMemory(&Instance->Unmatched_persons, Instance->num_persons);
-	
-	if (Instance->Prices == NULL || Instance->Matching == NULL || Instance->Matching_costs == NULL || Instance->Unmatched_persons.container == NULL)
+	// Split the edges in parts that begin at the beginning of a line.
+	error = TP_Create(&Instance->Workers, Instance->num_threads);
+	num_threads = Instance->Workers.num_threads;
+	task_arg.Instance = Instance;
+	task_arg.text = text;
+	task_arg.parts = (long int*) malloc((num_threads + 1) * sizeof(long int));
+	task_arg.max_abs = (int*) malloc(num_threads * sizeof(int));
+	task_arg.out_of_range = (int*) malloc(num_threads * sizeof(int));
+	task_arg.no_memory = (int*) malloc(num_threads * sizeof(int));
+	task_arg.Part_edges = (int**) calloc(num_threads, sizeof(int*));
+	task_arg.Part_first = (int*) calloc(num_threads, sizeof(int));
+	task_arg.Part_size = (int*) calloc(num_threads, sizeof(int));
+	if (error.code == -1 || task_arg.parts == NULL || task_arg.max_abs == NULL || task_arg.out_of_range == NULL
+		|| task_arg.no_memory == NULL || task_arg.Part_edges == NULL || task_arg.Part_first == NULL || task_arg.Part_size == NULL)
 	{
-		Error_Set(&error, -1, "Error: no memory for the allocation of the auxiliary structures in 'AS_Solve_Instance'.");
-		AS_Clear(Instance);
+		AS_Free_text_task_arg(&task_arg, num_threads);
+		munmap(text, text_size);
+		Instance->num_persons = 0;
+		Instance->num_objects = 0;
+		if (error.code == -1) strcat(error.msg, " In 'AS_Load_graph_Text'");
+		else Error_Set(&error, -1, "Error: no memory for the allocation of the graph in 'AS_Load_graph_Text'");
 		return error;
 	}
+	for(int thread_i = 0; thread_i <= num_threads; ++thread_i)
+	{
+		task_arg.parts[thread_i] = position + (text_size - position) * thread_i / num_threads;
+		if (thread_i > 0 && task_arg.parts[thread_i] > task_arg.parts[thread_i - 1] && text[task_arg.parts[thread_i] - 1] != '\n')
+			task_arg.parts[thread_i] = Next_line(text, text_size, task_arg.parts[thread_i]);
+		if (thread_i > 0 && task_arg.parts[thread_i] < task_arg.parts[thread_i - 1])
+			task_arg.parts[thread_i] = task_arg.parts[thread_i - 1];
+	}
 	
-	for(int object_i = 0; object_i < Instance->num_objects; ++object_i)
+	// First pass: count the neighbors of each person in each part.
+	task_arg.place_edges = 0;
+	TP_Run(&Instance->Workers, AS_Parse_edges_task, &task_arg);
+	for(int thread_i = 0; thread_i < num_threads; ++thread_i)
 	{
-		Instance->Prices[object_i] = 0;
-		Instance->Matching_costs[object_i] = 0;
+		out_of_range |= task_arg.out_of_range[thread_i];
+		no_memory |= task_arg.no_memory[thread_i];
 	}
 	
-	epsilon = initial_epsilon;
-	//If no limit for epsilon was passed, use an optimal value.
-	if(final_epsilon == 0) final_epsilon = 1.0 / (Instance->num_persons + 2.0);
+	// Make the allocation of the memory.
+	if (!out_of_range && !no_memory)
+	{
+		count = 0;
+		for(int thread_i = 0; thread_i < num_threads; ++thread_i)
+			for(int k = 0; k < task_arg.Part_size[thread_i]; ++k) count += task_arg.Part_edges[thread_i][k];
+		error = Graph_Allocate(&Instance->Persons, Instance->num_persons, count);
+	}
+	if (out_of_range || no_memory || error.code == -1)
+	{
+		AS_Free_text_task_arg(&task_arg, num_threads);
+		munmap(text, text_size);
+		Instance->num_persons = 0;
+		Instance->num_objects = 0;
+		if (out_of_range) Error_Set(&error, -1, "Error: person or object index out of range in 'AS_Load_graph_Text'");
+		else if (no_memory) Error_Set(&error, -1, "Error: no memory for the allocation of the graph in 'AS_Load_graph_Text'");
+		else strcat(error.msg, " In 'AS_Load_graph_Text'");
+		return error;
+	}
+	
+	// Turn the counts into the beginning of each adjacency list, and of the edges of each part in it. The offsets
+	// first get the number of edges of each person and then the position of its next edge, going over the parts in order.
+	memset(Instance->Persons.offsets, 0, ((long int)Instance->num_persons + 1) * sizeof(int));
+	for(int thread_i = 0; thread_i < num_threads; ++thread_i)
+		for(int k = 0; k < task_arg.Part_size[thread_i]; ++k)
+			Instance->Persons.offsets[task_arg.Part_first[thread_i] + k + 1] += task_arg.Part_edges[thread_i][k];
+	for(int person_i = 0; person_i < Instance->num_persons; ++person_i)
+		Instance->Persons.offsets[person_i + 1] += Instance->Persons.offsets[person_i];
+	for(int thread_i = 0; thread_i < num_threads; ++thread_i)
+	{
+		counts = task_arg.Part_edges[thread_i];
+		for(int k = 0; k < task_arg.Part_size[thread_i]; ++k)
+		{
+			count = counts[k];
+			counts[k] = Instance->Persons.offsets[task_arg.Part_first[thread_i] + k];
+			Instance->Persons.offsets[task_arg.Part_first[thread_i] + k] += count;
+		}
+	}
+	for(int person_i = Instance->num_persons; person_i > 0; --person_i)
+		Instance->Persons.offsets[person_i] = Instance->Persons.offsets[person_i - 1];
+	Instance->Persons.offsets[0] = 0;
+	
+	// Second pass: place each edge in its adjacency list.
+	task_arg.place_edges = 1;
+	TP_Run(&Instance->Workers, AS_Parse_edges_task, &task_arg);
+	for(int thread_i = 0; thread_i < num_threads; ++thread_i)
+		if (task_arg.max_abs[thread_i] > Instance->max_abs_cost) Instance->max_abs_cost = task_arg.max_abs[thread_i];
+	
+	Graph_Check_dense(&Instance->Persons, Instance->num_objects);
+	
+	// Free the auxiliary arrays.
+	AS_Free_text_task_arg(&task_arg, num_threads);
+	munmap(text, text_size);
+	
+	Error_Set(&error, 1, "OK");
+	Instance->Timings.load_time = Wall_time() - start_time;
+	return error;
+}
+
+// Load a complete graph given by its matrix of costs from the file in 'file_path' onto the AuctionSolver instance.
+// The first line of the file has the number of rows (persons) and of columns (objects), and each of the next lines
+// has a row of costs, separated by spaces or commas. The graph is dense (see 'AS_Set_matrix').
+// The members that will be modified are: 'num_persons, num_objects, max_abs_cost, Persons'.
+Error	AS_Load_matrix_Text(AuctionSolver *Instance, char *file_path)
+{
+	Error		error;
+	char		*text = NULL;
+	long int	text_size = 0;
+	long int	position = 0;
+	int			num_rows = -1;
+	int			num_columns = -1;
+	int			cost = 0;
+	costType	*row;
+	double		start_time = Wall_time();
+	
+	
+	// Map the text file.
+	text = (char*) Map_file(file_path, &text_size);
+	if (text == NULL)
+	{
+		Error_Set(&error, -1, "Error: the matrix file does not exist or is empty, in 'AS_Load_matrix_Text'");
+		return error;
+	}
+	madvise(text, text_size, MADV_SEQUENTIAL);
+	
+	// Read the size of the matrix and make the allocation of the memory.
+	Instance->is_solved = 0;
+	AS_Clear_order(Instance);
+	Instance->max_abs_cost = 0;
+	if (!Parse_int(text, text_size, &position, &num_rows) || !Parse_int(text, text_size, &position, &num_columns)
+		|| num_rows < 0 || num_columns < 0) Error_Set(&error, -1, "Error: corrupted matrix file in 'AS_Load_matrix_Text'");
+	else
+	{
+		error = Graph_Allocate_dense(&Instance->Persons, num_rows, num_columns);
+		if (error.code == -1) strcat(error.msg, " In 'AS_Load_matrix_Text'");
+	}
+	
+	// Read the rows.
+	for(int person_i = 0; person_i < num_rows && error.code == 1; ++person_i)
+	{
+		position = Next_line(text, text_size, position);
+		row = Instance->Persons.costs + (long int)person_i * num_columns;
+		for(int object_j = 0; object_j < num_columns && error.code == 1; ++object_j)
+		{
+			if (!Parse_int(text, text_size, &position, &cost))
+				Error_Set(&error, -1, "Error: a row of the matrix has less costs than columns, in 'AS_Load_matrix_Text'");
+			row[object_j] = (costType) cost;
+			if (abs(cost) > Instance->max_abs_cost) Instance->max_abs_cost = abs(cost);
+		}
+	}
+	munmap(text, text_size);
+	if (error.code == -1)
+	{
+		Graph_Clear(&Instance->Persons);
+		Instance->num_persons = 0;
+		Instance->num_objects = 0;
+		return error;
+	}
+	Instance->num_persons = num_rows;
+	Instance->num_objects = num_columns;
+	
+	Instance->Timings.load_time = Wall_time() - start_time;
+	return error;
+}
+
+// Load a graph from the file in 'file_path' onto the AuctionSolver instance.
+// The file format must be '.wbg2' (see 'Wbg2_Header').
+// If the costs in the file have the size of 'costType', the graph points directly inside the mapped file and
+// nothing is parsed or copied, only the offsets and the neighbors are checked. Otherwise the graph is copied
+// and the costs are converted.
+// The members that will be modified are: 'num_persons, num_objects, max_abs_cost, Persons'.
+Error	AS_Load_graph_Wbg2(AuctionSolver *Instance, char *file_path)
+{
+	Error		error = {0, ""};
+	char		*file_data = NULL;
+	long int	file_size = 0;
+	Wbg2_Header	header;
+	int			*offsets;
+	int			*neighbors;
+	char		*costs;
+	int			corrupted = 0;
+	double		cost = 0;
+	double		start_time = Wall_time();
+	
+	
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+	Error_Set(&error, -1, "Error: the '.wbg2' files can only be used on little-endian machines, in 'AS_Load_graph_Wbg2'");
+	return error;
+#endif
+	
+	// Map the graph file and check for errors.
+	Instance->is_solved = 0;
+	AS_Clear_order(Instance);
+	Graph_Clear(&Instance->Persons);
+	file_data = (char*) Map_file(file_path, &file_size);
+	if (file_data == NULL)
+	{
+		Error_Set(&error, -1, "Error: the graph file does not exist or is empty, in 'AS_Load_graph_Wbg2'");
+		return error;
+	}
+	
+	// Check the header and that the arrays fit in the file.
+	memset(&header, 0, sizeof(Wbg2_Header));
+	if (file_size >= (long int)sizeof(Wbg2_Header)) memcpy(&header, file_data, sizeof(Wbg2_Header));
+	if (file_size < (long int)sizeof(Wbg2_Header) || memcmp(header.magic, WBG2_MAGIC, 4) != 0 || header.version != WBG2_VERSION
+		|| header.num_persons < 0 || header.num_objects < 0 || header.num_edges < 0 || header.num_edges > 2147483647
+		|| header.max_abs_cost < 0 || header.max_abs_cost > 2147483647 || (header.cost_width != 4 && header.cost_width != 8)
+		|| Wbg2_Costs_position(&header) + header.num_edges * header.cost_width > file_size)
+		corrupted = 1;
+	
+	// Check that the adjacency lists are consecutive and that the neighbors are objects.
+	offsets = (int*)(file_data + Wbg2_Offsets_position(&header));
+	neighbors = (int*)(file_data + Wbg2_Neighbors_position(&header));
+	costs = file_data + Wbg2_Costs_position(&header);
+	if (!corrupted)
+		corrupted = (offsets[0] != 0 || offsets[header.num_persons] != header.num_edges);
+	for(int person_i = 0; person_i < header.num_persons && !corrupted; ++person_i)
+		corrupted = (offsets[person_i] > offsets[person_i + 1]);
+	for(long int k = 0; k < header.num_edges && !corrupted; ++k)
+		corrupted = (neighbors[k] < 0 || neighbors[k] >= header.num_objects);
+	if (corrupted)
+	{
+		munmap(file_data, file_size);
+		Error_Set(&error, -1, "Error: corrupted graph file in 'AS_Load_graph_Wbg2'");
+		return error;
+	}
+	Instance->num_persons = header.num_persons;
+	Instance->num_objects = header.num_objects;
+	Instance->max_abs_cost = (int)header.max_abs_cost;
+	
+	// Use the file in place.
+	if (header.cost_width == sizeof(costType))
+	{
+		Instance->Persons.num_persons = header.num_persons;
+		Instance->Persons.num_edges = (int)header.num_edges;
+		Instance->Persons.offsets = offsets;
+		Instance->Persons.neighbors = neighbors;
+		Instance->Persons.costs = (costType*) costs;
+		Instance->Persons.mapped_base = file_data;
+		Instance->Persons.mapped_size = file_size;
+		Graph_Check_dense(&Instance->Persons, Instance->num_objects);
+		
+		Error_Set(&error, 1, "OK");
+		Instance->Timings.load_time = Wall_time() - start_time;
+		return error;
+	}
+	
+	// Copy the graph, converting the costs.
+	error = Graph_Allocate(&Instance->Persons, header.num_persons, (int)header.num_edges);
+	if (error.code == -1)
+	{
+		munmap(file_data, file_size);
+		Instance->num_persons = 0;
+		Instance->num_objects = 0;
+		strcat(error.msg, " In 'AS_Load_graph_Wbg2'");
+		return error;
+	}
+	memcpy(Instance->Persons.offsets, offsets, ((long int)header.num_persons + 1) * sizeof(int));
+	memcpy(Instance->Persons.neighbors, neighbors, header.num_edges * sizeof(int));
+	for(long int k = 0; k < header.num_edges; ++k)
+	{
+		if (header.cost_width == 4) cost = ((int*)costs)[k];
+		else cost = ((double*)costs)[k];
+		// The integer mode can only keep integer costs of 32 bits.
+		if (sizeof(costType) == 4 && (cost != (double)(int)cost || cost < -2147483647.0 || cost > 2147483647.0))
+		{
+			munmap(file_data, file_size);
+			Graph_Clear(&Instance->Persons);
+			Instance->num_persons = 0;
+			Instance->num_objects = 0;
+			Error_Set(&error, -1, "Error: the graph file has costs that are not 32 bits integers, in 'AS_Load_graph_Wbg2'");
+			return error;
+		}
+		Instance->Persons.costs[k] = (costType) cost;
+	}
+	Graph_Check_dense(&Instance->Persons, Instance->num_objects);
+	munmap(file_data, file_size);
+	
+	Error_Set(&error, 1, "OK");
+	Instance->Timings.load_time = Wall_time() - start_time;
+	return error;
+}
+
+// Replace the graph of the AuctionSolver instance by a copy of the complete graph with 'num_persons' persons and
+// 'num_objects' objects, whose costs are given by the 'num_persons x num_objects' row-major matrix 'costs': the cost
+// of the edge between person 'i' and object 'j' is 'costs[i * num_objects + j]'. The graph is dense, so it does not
+// store the neighbors (see 'Graph' in "types.h"). The memory of the current graph is reused if it is big enough.
+// The members that will be modified are: 'num_persons, num_objects, max_abs_cost, Persons'.
+// In case of error, an Error instance will be returned.
+Error	AS_Set_matrix(AuctionSolver *Instance, int num_persons, int num_objects, const costType *costs)
+{
+	Error	error;
+	double	start_time = Wall_time();
+	
+	Instance->is_solved = 0;
+	AS_Clear_order(Instance);
+	error = Graph_Allocate_dense(&Instance->Persons, num_persons, num_objects);
+	if (error.code == -1)
+	{
+		Instance->num_persons = 0;
+		Instance->num_objects = 0;
+		strcat(error.msg, " In 'AS_Set_matrix'");
+		return error;
+	}
+	Instance->num_persons = num_persons;
+	Instance->num_objects = num_objects;
+	memcpy(Instance->Persons.costs, costs, Instance->Persons.num_edges * sizeof(costType));
+	
+	// Find the maximum absolute cost.
+	Instance->max_abs_cost = 0;
+	for(int k = 0; k < Instance->Persons.num_edges; ++k)
+		if (abs((int)costs[k]) > Instance->max_abs_cost) Instance->max_abs_cost = abs((int)costs[k]);
+	
+	Instance->Timings.load_time = Wall_time() - start_time;
+	return error;
+}
+
+// Replace the graph of the AuctionSolver instance by a copy of the graph with 'num_persons' persons and 'num_objects'
+// objects given by the arrays of its adjacency lists in CSR format (see 'Graph' in "types.h"). The memory of the current
+// graph is reused if it is big enough.
+// If 'neighbors' is NULL the graph is complete and 'costs' is its row-major matrix, as in 'AS_Set_matrix'.
+// The members that will be modified are: 'num_persons, num_objects, max_abs_cost, Persons'.
+// In case of error, an Error instance will be returned.
+Error	AS_Set_graph(AuctionSolver *Instance, int num_persons, int num_objects, const int *offsets, const int *neighbors, const costType *costs)
+{
+	Error	error;
+	int		num_edges = (num_persons > 0 ? offsets[num_persons] : 0);
+	double	start_time = Wall_time();
+	
+	if (neighbors == NULL) return AS_Set_matrix(Instance, num_persons, num_objects, costs);
+	Instance->is_solved = 0;
+	AS_Clear_order(Instance);
+	error = Graph_Allocate(&Instance->Persons, num_persons, num_edges);
+	if (error.code == -1)
+	{
+		Instance->num_persons = 0;
+		Instance->num_objects = 0;
+		strcat(error.msg, " In 'AS_Set_graph'");
+		return error;
+	}
+	Instance->num_persons = num_persons;
+	Instance->num_objects = num_objects;
+	memcpy(Instance->Persons.offsets, offsets, (num_persons + 1) * sizeof(int));
+	memcpy(Instance->Persons.neighbors, neighbors, num_edges * sizeof(int));
+	memcpy(Instance->Persons.costs, costs, num_edges * sizeof(costType));
+	
+	// Find the maximum absolute cost.
+	Instance->max_abs_cost = 0;
+	for(int k = 0; k < num_edges; ++k)
+		if (abs((int)costs[k]) > Instance->max_abs_cost) Instance->max_abs_cost = abs((int)costs[k]);
+	Graph_Check_dense(&Instance->Persons, num_objects);
+	
+	Instance->Timings.load_time = Wall_time() - start_time;
+	return error;
+}
+
+// Map the original indices of a person and an object to their indices in the reordered graph (see 'AS_Reorder_graph').
+// The indices out of range are left as they are, for the caller to report them.
+void	AS_Map_vertices(AuctionSolver *Instance, int *person_i, int *object_j)
+{
+	if (Instance->Person_positions == NULL) return;
+	if (*person_i >= 0 && *person_i < Instance->num_persons) *person_i = Instance->Person_positions[*person_i];
+	if (*object_j >= 0 && *object_j < Instance->num_objects) *object_j = Instance->Object_positions[*object_j];
+}
+
+// Change the cost of the edge between person 'person_i' and object 'object_j' to 'cost'. The indices are the ones of the
+// original graph, also after 'AS_Reorder_graph' (and so in 'AS_Add_edge' and 'AS_Remove_edge').
+// The solution of the previous solve is kept, to solve again with 'AS_Resolve_Instance'.
+// In case of error, an Error instance will be returned.
+Error	AS_Update_cost(AuctionSolver *Instance, int person_i, int object_j, costType cost)
+{
+	Error	error = {1, "OK"};
+	int		position = -1;
+	
+	AS_Map_vertices(Instance, &person_i, &object_j);
+	if (person_i >= 0 && person_i < Instance->num_persons && object_j >= 0 && object_j < Instance->num_objects)
+		position = Graph_Find_edge(&Instance->Persons, person_i, object_j);
+	if (position == -1)
+	{
+		Error_Set(&error, -1, "Error: the edge does not exist in 'AS_Update_cost'");
+		return error;
+	}
+	Instance->Persons.costs[position] = cost;
+	if (abs((int)cost) > Instance->max_abs_cost) Instance->max_abs_cost = abs((int)cost);
+	if (Instance->is_solved && Instance->Matching[object_j] == person_i) Instance->Matching_costs[object_j] = cost;
+	
+	return error;
+}
+
+// Add an edge between person 'person_i' and object 'object_j' with cost 'cost'.
+// The solution of the previous solve is kept, to solve again with 'AS_Resolve_Instance'.
+// In case of error, an Error instance will be returned.
+Error	AS_Add_edge(AuctionSolver *Instance, int person_i, int object_j, costType cost)
+{
+	Error	error = {1, "OK"};
+	
+	AS_Map_vertices(Instance, &person_i, &object_j);
+	if (person_i < 0 || person_i >= Instance->num_persons || object_j < 0 || object_j >= Instance->num_objects)
+	{
+		Error_Set(&error, -1, "Error: person or object index out of range in 'AS_Add_edge'");
+		return error;
+	}
+	if (Graph_Find_edge(&Instance->Persons, person_i, object_j) != -1)
+	{
+		Error_Set(&error, -1, "Error: the edge already exists in 'AS_Add_edge'");
+		return error;
+	}
+	error = Graph_Add_edge(&Instance->Persons, person_i, object_j, cost);
+	if (error.code == -1)
+	{
+		strcat(error.msg, " In 'AS_Add_edge'");
+		return error;
+	}
+	if (abs((int)cost) > Instance->max_abs_cost) Instance->max_abs_cost = abs((int)cost);
+	
+	return error;
+}
+
+// Remove the edge between person 'person_i' and object 'object_j'. If they are matched, the person is unmatched and
+// will bid again in 'AS_Resolve_Instance'.
+// In case of error, an Error instance will be returned.
+Error	AS_Remove_edge(AuctionSolver *Instance, int person_i, int object_j)
+{
+	Error	error = {1, "OK"};
+	int		position = -1;
+	
+	AS_Map_vertices(Instance, &person_i, &object_j);
+	if (person_i >= 0 && person_i < Instance->num_persons && object_j >= 0 && object_j < Instance->num_objects)
+		position = Graph_Find_edge(&Instance->Persons, person_i, object_j);
+	if (position == -1)
+	{
+		Error_Set(&error, -1, "Error: the edge does not exist in 'AS_Remove_edge'");
+		return error;
+	}
+	// A dense graph has to store its neighbors first.
+	error = Graph_Reserve_edges(&Instance->Persons, Instance->Persons.num_edges);
+	if (error.code == -1)
+	{
+		strcat(error.msg, " In 'AS_Remove_edge'");
+		return error;
+	}
+	Graph_Remove_edge(&Instance->Persons, person_i, position);
+	if (Instance->is_solved && Instance->Matching[object_j] == person_i)
+	{
+		Instance->Matching[object_j] = UNMATCHED;
+		Instance->Matching_costs[object_j] = 0;
+		BD_Push_Back(&Instance->Unmatched_persons, person_i);
+	}
+	
+	return error;
+}
+
+// Name of an order of 'AS_Reorder_graph', for reporting.
+const char	*AS_Order_name(int order)
+{
+	return (order == AS_ORDER_RCM ? "rcm" : "bfs");
+}
+
+// The 'AS_ORDER_*' value of an order given its name, or '-1' if there is no order with that name.
+int		AS_Order_from_name(const char *name)
+{
+	for (int order = AS_ORDER_BFS; order <= AS_ORDER_RCM; ++order)
+		if (strcmp(name, AS_Order_name(order)) == 0) return order;
+	return -1;
+}
+
+// Compare two keys of 'AS_Reorder_graph' ('qsort' function).
+int		AS_Compare_keys(const void *first, const void *second)
+{
+	long long	first_key = *(const long long*) first;
+	long long	second_key = *(const long long*) second;
+	
+	return (first_key > second_key) - (first_key < second_key);
+}
+
+// Renumber the persons and the objects so that the neighbors of each person have close indices, and so the accesses to
+// the prices of its objects (and to the other arrays of the objects) hit the same cache lines. The persons and the objects
+// are numbered in the order in which a breadth first search of the graph reaches them, starting each connected component
+// from a person of minimum degree. With 'AS_ORDER_RCM' the neighbors of each vertex are visited from the smallest degree
+// to the biggest and the order is reversed at the end (reverse Cuthill-McKee), which gives a smaller bandwidth.
+// The adjacency lists of the reordered graph are sorted by object, so each scan reads the prices forward.
+// The original indices are kept in 'Person_labels' and 'Object_labels': the edges are changed and the matching is saved
+// with them. A dense graph is not reordered, since its scans already read the whole array of prices in order.
+// In case of error, an Error instance will be returned and the graph is not changed.
+Error	AS_Reorder_graph(AuctionSolver *Instance, int order)
+{
+	Error		error = {1, "OK"};
+	int			num_persons = Instance->num_persons;
+	int			num_objects = Instance->num_objects;
+	int			num_vertices = num_persons + num_objects;
+	Graph		*Persons = &Instance->Persons;
+	// The adjacency lists of the objects, and the reordered graph.
+	Graph		Objects;
+	Graph		Reordered;
+	// The new order of the vertices (the persons are '0, ..., num_persons - 1' and the object 'j' is 'num_persons + j'),
+	// which is also the queue of the search, and the new index of each vertex, or -1.
+	int			*Queue = NULL;
+	int			*Positions = NULL;
+	// The persons sorted by degree, to start the components, and the keys to sort the new neighbors by degree.
+	long long	*Keys = NULL;
+	long long	*Neighbor_keys = NULL;
+	int			queue_begin = 0;
+	int			queue_end = 0;
+	int			next_start = 0;
+	int			num_new = 0;
+	int			v = 0;
+	int			w = 0;
+	int			position = 0;
+	const Graph	*Adjacency;
+	
+	if (order != AS_ORDER_BFS && order != AS_ORDER_RCM)
+	{
+		Error_Set(&error, -1, "Error: unknown order in 'AS_Reorder_graph'");
+		return error;
+	}
+	if (num_persons <= 0 || num_objects <= 0 || Persons->neighbors == NULL) return error;
+	Graph_Defaults(&Objects);
+	Graph_Defaults(&Reordered);
+	error = Graph_Transpose(Persons, num_objects, &Objects);
+	if (error.code == 1) error = Graph_Allocate(&Reordered, num_persons, Persons->num_edges);
+	if (error.code == -1)
+	{
+		Graph_Clear(&Objects);
+		strcat(error.msg, " In 'AS_Reorder_graph'");
+		return error;
+	}
+	Queue = (int*) malloc(num_vertices * sizeof(int));
+	Positions = (int*) malloc(num_vertices * sizeof(int));
+	Keys = (long long*) malloc(2 * (long int)num_vertices * sizeof(long long));
+	if (Queue == NULL || Positions == NULL || Keys == NULL)
+	{
+		Error_Set(&error, -1, "Error: no memory for the allocation in 'AS_Reorder_graph'");
+		free((char*) Queue);
+		free((char*) Positions);
+		free((char*) Keys);
+		Graph_Clear(&Objects);
+		Graph_Clear(&Reordered);
+		return error;
+	}
+	Neighbor_keys = Keys + num_vertices;
+	
+	//The persons by degree, to start each component from one of minimum degree.
+	for(int person_i = 0; person_i < num_persons; ++person_i)
+		Keys[person_i] = (long long)(Persons->offsets[person_i + 1] - Persons->offsets[person_i]) * num_vertices + person_i;
+	qsort(Keys, num_persons, sizeof(long long), AS_Compare_keys);
+	for(v = 0; v < num_vertices; ++v) Positions[v] = -1;
+	
+	//Breadth first search of each component, alternating persons and objects.
+	while(queue_end < num_vertices)
+	{
+		if (queue_begin == queue_end)
+		{
+			while(next_start < num_persons && Positions[Keys[next_start] % num_vertices] != -1) ++next_start;
+			//The objects without neighbors go last.
+			if (next_start == num_persons)
+			{
+				for(v = num_persons; v < num_vertices; ++v)
+					if (Positions[v] == -1) Queue[Positions[v] = queue_end++] = v;
+				break;
+			}
+			v = (int)(Keys[next_start] % num_vertices);
+			Queue[Positions[v] = queue_end++] = v;
+		}
+		v = Queue[queue_begin++];
+		Adjacency = (v < num_persons ? Persons : &Objects);
+		w = (v < num_persons ? v : v - num_persons);
+		num_new = 0;
+		for(int k = Adjacency->offsets[w]; k < Adjacency->offsets[w + 1]; ++k)
+		{
+			position = Graph_Neighbor(Adjacency, w, k) + (v < num_persons ? num_persons : 0);
+			if (Positions[position] != -1) continue;
+			Positions[position] = queue_end + num_new;
+			Queue[queue_end + num_new++] = position;
+		}
+		//Cuthill-McKee: the new neighbors from the smallest degree to the biggest.
+		if (order == AS_ORDER_RCM && num_new > 1)
+		{
+			Adjacency = (v < num_persons ? &Objects : Persons);
+			for(int n = 0; n < num_new; ++n)
+			{
+				w = Queue[queue_end + n] - (v < num_persons ? num_persons : 0);
+				Neighbor_keys[n] = (long long)(Adjacency->offsets[w + 1] - Adjacency->offsets[w]) * num_vertices + Queue[queue_end + n];
+			}
+			qsort(Neighbor_keys, num_new, sizeof(long long), AS_Compare_keys);
+			for(int n = 0; n < num_new; ++n)
+			{
+				Queue[queue_end + n] = (int)(Neighbor_keys[n] % num_vertices);
+				Positions[Queue[queue_end + n]] = queue_end + n;
+			}
+		}
+		queue_end += num_new;
+	}
+	
+	//The indices of the persons and the objects in their own sides, reversed with 'AS_ORDER_RCM'.
+	position = 0;
+	w = 0;
+	for(int q = 0; q < num_vertices; ++q)
+	{
+		v = Queue[order == AS_ORDER_RCM ? num_vertices - 1 - q : q];
+		if (v < num_persons) Positions[v] = position++;
+		else Positions[v] = w++;
+	}
+	
+	//The reordered graph: the lists of the persons are filled object by object, so they are sorted.
+	Reordered.offsets[0] = 0;
+	for(v = 0; v < num_persons; ++v) Queue[Positions[v]] = v;
+	for(int person_i = 0; person_i < num_persons; ++person_i)
+		Reordered.offsets[person_i + 1] = Reordered.offsets[person_i]
+			+ Persons->offsets[Queue[person_i] + 1] - Persons->offsets[Queue[person_i]];
+	for(v = 0; v < num_objects; ++v) Queue[num_persons + Positions[num_persons + v]] = v;
+	for(int object_j = 0; object_j < num_objects; ++object_j)
+	{
+		w = Queue[num_persons + object_j];
+		for(int k = Objects.offsets[w]; k < Objects.offsets[w + 1]; ++k)
+		{
+			position = Reordered.offsets[Positions[Graph_Neighbor(&Objects, w, k)]]++;
+			Reordered.neighbors[position] = object_j;
+			Reordered.costs[position] = Objects.costs[k];
+		}
+	}
+	for(int person_i = num_persons; person_i > 0; --person_i) Reordered.offsets[person_i] = Reordered.offsets[person_i - 1];
+	Reordered.offsets[0] = 0;
+	
+	//The labels, composed with the ones of a previous reordering.
+	if (Instance->Person_labels == NULL)
+	{
+		Allocate_array((char**)&Instance->Person_labels, num_persons * sizeof(int));
+		Allocate_array((char**)&Instance->Object_labels, num_objects * sizeof(int));
+		Allocate_array((char**)&Instance->Person_positions, num_persons * sizeof(int));
+		Allocate_array((char**)&Instance->Object_positions, num_objects * sizeof(int));
+		if (Instance->Person_labels == NULL || Instance->Object_labels == NULL
+			|| Instance->Person_positions == NULL || Instance->Object_positions == NULL)
+		{
+			AS_Clear_order(Instance);
+			Error_Set(&error, -1, "Error: no memory for the labels in 'AS_Reorder_graph'");
+		}
+		else
+		{
+			for(int person_i = 0; person_i < num_persons; ++person_i) Instance->Person_labels[person_i] = person_i;
+			for(int object_j = 0; object_j < num_objects; ++object_j) Instance->Object_labels[object_j] = object_j;
+		}
+	}
+	if (error.code == 1)
+	{
+		//'Keys' keeps the previous labels.
+		for(v = 0; v < num_persons; ++v) Keys[v] = Instance->Person_labels[v];
+		for(v = 0; v < num_objects; ++v) Keys[num_persons + v] = Instance->Object_labels[v];
+		for(v = 0; v < num_persons; ++v)
+		{
+			Instance->Person_labels[Positions[v]] = (int)Keys[v];
+			Instance->Person_positions[Keys[v]] = Positions[v];
+		}
+		for(v = 0; v < num_objects; ++v)
+		{
+			Instance->Object_labels[Positions[num_persons + v]] = (int)Keys[num_persons + v];
+			Instance->Object_positions[Keys[num_persons + v]] = Positions[num_persons + v];
+		}
+		Graph_Clear(Persons);
+		*Persons = Reordered;
+		Graph_Defaults(&Reordered);
+		Instance->is_solved = 0;
+	}
+	
+	free((char*) Queue);
+	free((char*) Positions);
+	free((char*) Keys);
+	Graph_Clear(&Objects);
+	Graph_Clear(&Reordered);
+	return error;
+}
+
+// Save the graph of the AuctionSolver instance to the file in 'file_path', in '.wbg2' format.
+// The costs are saved with the size of 'costType', so that the file can be used in place by the same build.
+// In case of error, an Error instance will be returned.
+Error	AS_Save_graph_Wbg2(AuctionSolver *Instance, char *file_path)
+{
+	Error		error = {0, ""};
+	FILE		*output_file;
+	Wbg2_Header	header;
+	char		zeros[WBG2_ALIGNMENT] = {0};
+	long int	position = 0;
+	int			written = 1;
+	// The adjacency list of the persons of a dense graph.
+	int			*Row = NULL;
+	
+	
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+	Error_Set(&error, -1, "Error: the '.wbg2' files can only be used on little-endian machines, in 'AS_Save_graph_Wbg2'");
+	return error;
+#endif
+	
+	memset(&header, 0, sizeof(Wbg2_Header));
+	memcpy(header.magic, WBG2_MAGIC, 4);
+	header.version = WBG2_VERSION;
+	header.num_persons = Instance->num_persons;
+	header.num_objects = Instance->num_objects;
+	header.num_edges = Instance->Persons.num_edges;
+	header.cost_width = sizeof(costType);
+	header.is_dense = Instance->Persons.is_dense;
+	header.max_abs_cost = Instance->max_abs_cost;
+	
+	output_file = fopen(file_path, "wb");
+	if (output_file == NULL)
+	{
+		Error_Set(&error, -1, "Error: the file could not be created in 'AS_Save_graph_Wbg2'");
+		return error;
+	}
+	
+	// Write each array at its position, filling the gaps with zeros.
+	written &= (fwrite(&header, sizeof(Wbg2_Header), 1, output_file) == 1);
+	written &= (fwrite(Instance->Persons.offsets, sizeof(int), header.num_persons + 1, output_file) == (size_t)header.num_persons + 1);
+	position = Wbg2_Offsets_position(&header) + ((long int)header.num_persons + 1) * sizeof(int);
+	written &= (fwrite(zeros, 1, Wbg2_Neighbors_position(&header) - position, output_file) == (size_t)(Wbg2_Neighbors_position(&header) - position));
+	if (Instance->Persons.neighbors != NULL)
+		written &= (fwrite(Instance->Persons.neighbors, sizeof(int), header.num_edges, output_file) == (size_t)header.num_edges);
+	else
+	{
+		// A dense graph does not store the neighbors: each adjacency list is {0, ..., num_objects - 1}.
+		Row = (int*) malloc(header.num_objects * sizeof(int));
+		written &= (Row != NULL);
+		for(int object_j = 0; object_j < header.num_objects && written; ++object_j) Row[object_j] = object_j;
+		for(int person_i = 0; person_i < header.num_persons && written; ++person_i)
+			written &= (fwrite(Row, sizeof(int), header.num_objects, output_file) == (size_t)header.num_objects);
+		free((char*) Row);
+	}
+	position = Wbg2_Neighbors_position(&header) + header.num_edges * sizeof(int);
+	written &= (fwrite(zeros, 1, Wbg2_Costs_position(&header) - position, output_file) == (size_t)(Wbg2_Costs_position(&header) - position));
+	written &= (fwrite(Instance->Persons.costs, sizeof(costType), header.num_edges, output_file) == (size_t)header.num_edges);
+	written &= (fclose(output_file) == 0);
+	if (!written)
+	{
+		Error_Set(&error, -1, "Error: the graph could not be written in 'AS_Save_graph_Wbg2'");
+		return error;
+	}
+	
+	Error_Set(&error, 1, "OK");
+	return error;
+}
+
+// Save the resulting matching and its cost to a text file. The time of writing it is left in 'Timings.output_time'.
+void	AS_Save_matching_Text(AuctionSolver *Instance, char *file_path)
+{
+	FILE	*output_file;
+	double	start_time = Wall_time();
+	
+	// Save the matching cost and the solving time, and the times of the steps, one per line as "name time"
+	// (the times of the phases in one line).
+	output_file = fopen(file_path, "w");
+	fprintf(output_file, "cost %.0f\n", (double)Instance->matching_cost);
+	fprintf(output_file, "time %f\n", Instance->solving_time);
+	fprintf(output_file, "load_time %f\npresolve_time %f\nprepare_time %f\nphases_time %f\n", Instance->Timings.load_time,
+		Instance->Timings.presolve_time, Instance->Timings.prepare_time, Instance->Timings.phases_time);
+	fprintf(output_file, "phase_times");
+	for (int phase_i = 0; phase_i < Instance->num_phases; ++phase_i) fprintf(output_file, " %f", Instance->Phases[phase_i].wall_time);
+	fprintf(output_file, "\nextraction_time %f\n", Instance->Timings.extraction_time);
+	// Save the matching edge by edge, space separated as: "person_index object_index cost". The unmatched objects are skipped.
+	// The indices are the ones of the original graph, also after 'AS_Reorder_graph'.
+	for (int object_i = 0; object_i < Instance->num_objects; ++object_i)
+	{
+		int		object_j = (Instance->Object_positions != NULL ? Instance->Object_positions[object_i] : object_i);
+		int		person_i = Instance->Matching[object_j];
+		
+		if (person_i == UNMATCHED) continue;
+		if (Instance->Person_labels != NULL) person_i = Instance->Person_labels[person_i];
+		fprintf(output_file, "%d,%d,%.0lf\n", person_i, object_i, (double)Instance->Matching_costs[object_j]);
+	}
+	
+	fclose(output_file);
+	Instance->Timings.output_time = Wall_time() - start_time;
+}
+
+#ifdef AS_STATS
+// Save the trace and the statistics of the phases of the last solve to a JSON file, as an object with the totals and
+// an array "phases" with one object per scaling phase.
+// In case of error, an Error instance will be returned.
+Error	AS_Save_stats_Json(AuctionSolver *Instance, char *file_path)
+{
+	Error		error = {1, "OK"};
+	FILE		*output_file;
+	AS_Phase	*Phase;
+	int			num_buckets = 0;
+	
+	output_file = fopen(file_path, "w");
+	if (output_file == NULL)
+	{
+		Error_Set(&error, -1, "Error: the file can not be created in 'AS_Save_stats_Json'");
+		return error;
+	}
+	fprintf(output_file, "{\n  \"num_persons\": %d,\n  \"num_edges\": %d,\n", Instance->num_persons, Instance->Persons.num_edges);
+	fprintf(output_file, "  \"matching_cost\": %.0f,\n  \"solving_time\": %f,\n", (double)Instance->matching_cost, Instance->solving_time);
+	fprintf(output_file, "  \"timings\": {\"load_time\": %f, \"presolve_time\": %f, \"prepare_time\": %f, \"phases_time\": %f,",
+		Instance->Timings.load_time, Instance->Timings.presolve_time, Instance->Timings.prepare_time, Instance->Timings.phases_time);
+	fprintf(output_file, " \"extraction_time\": %f, \"output_time\": %f},\n", Instance->Timings.extraction_time, Instance->Timings.output_time);
+	fprintf(output_file, "  \"num_threads\": %d,\n", Instance->num_threads);
+	// The NUMA placement of the threads, with the CPU of each one ('-1' if it is not pinned).
+	if (Instance->numa_placement && Instance->Placement.num_threads > 1)
+	{
+		fprintf(output_file, "  \"numa\": {\"nodes\": %d, \"pinned_threads\": %d, \"interleaved_bytes\": %ld, \"threads\": [",
+			Instance->Placement.num_nodes, Instance->Placement.num_pinned, Instance->Placement.interleaved_bytes);
+		for (int thread_i = 0; thread_i < Instance->Placement.num_threads; ++thread_i)
+			fprintf(output_file, "%s{\"cpu\": %d, \"node\": %d}", thread_i > 0 ? ", " : "",
+				Instance->Placement.Thread_cpus[thread_i], Instance->Placement.Thread_nodes[thread_i]);
+		fprintf(output_file, "]},\n");
+	}
+	fprintf(output_file, "  \"phases\": [");
+	for (int phase_i = 0; phase_i < Instance->num_phases; ++phase_i)
+	{
+		Phase = &Instance->Phases[phase_i];
+		fprintf(output_file, "%s\n    {\"epsilon\": %.9g, \"unmatched\": %d, \"bids\": %ld, \"evictions\": %ld, \"neighbors_scanned\": %ld,",
+			phase_i > 0 ? "," : "", Phase->epsilon, Phase->unmatched, Phase->bids, Phase->stats.evictions, Phase->stats.neighbors_scanned);
+		fprintf(output_file, " \"wall_time\": %f, \"cpu_time\": %f,", Phase->wall_time, Phase->stats.cpu_time);
+		if (Phase->duality_gap >= 0) fprintf(output_file, " \"duality_gap\": %.9g,", Phase->duality_gap);
+		// The histogram without the empty buckets at the end.
+		num_buckets = AS_STATS_BUCKETS;
+		while (num_buckets > 0 && Phase->stats.increments[num_buckets - 1] == 0) --num_buckets;
+		fprintf(output_file, " \"increments\": [");
+		for (int bucket = 0; bucket < num_buckets; ++bucket)
+			fprintf(output_file, "%s%ld", bucket > 0 ? ", " : "", Phase->stats.increments[bucket]);
+		fprintf(output_file, "]}");
+	}
+	fprintf(output_file, "\n  ]\n}\n");
+	fclose(output_file);
+	return error;
+}
+#endif
+
+// Displays the graph contained in the 'AuctionSolver' instance.
+// It shows the number of persons and objects; and the adjacency lists of the persons as
+// pairs (neighbor, cost).
+// Only use on very small instances, to see that the instance is being loaded correctly.
+void	AS_Display_Instance(AuctionSolver *Instance)
+{
+	int			num_neighbors;
+	int			neighbor;
+	costType	cost;
+	
+	printf("------------------------------------------------------------\n");
+	printf("Num_Persons=%d, Num_Objects=%d\n", Instance->num_objects, Instance->num_objects);
+	for(int person_i = 0; person_i < Instance->num_persons; ++person_i)
+	{
+		num_neighbors = Instance->Persons.offsets[person_i + 1] - Instance->Persons.offsets[person_i];
+		printf("--------------\n");
+		printf("Num_Neighbors of p%d:%d\n", person_i, num_neighbors);
+		for(int edge_k = Instance->Persons.offsets[person_i]; edge_k < Instance->Persons.offsets[person_i + 1]; ++edge_k)
+		{
+			neighbor = Graph_Neighbor(&Instance->Persons, person_i, edge_k);
+			cost = Instance->Persons.costs[edge_k];
+			printf("(%d,%d) ", neighbor, (int)cost);
+		}
+		printf("\n");
+	}
+	printf("------------------------------------------------------------\n");
+}
+
+// Scan the adjacency list of the person 'I' with the kernel of the solver (the packed edges if there are): returns the
+// position in the list of its first best object, and the best and second best reduced costs by reference.
+// With only one neighbor both values are its reduced cost.
+int		AS_Scan_person(AuctionSolver *Instance, int I, priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	int		offset = Instance->Persons.offsets[I];
+	int		num_neighbors = Instance->Persons.offsets[I + 1] - offset;
+	
+	if (num_neighbors == 1)
+	{
+		*best_reduced_cost = (priceType)Instance->Persons.costs[offset] * Instance->price_scale
+			- Instance->Prices[Graph_Neighbor(&Instance->Persons, I, offset)];
+		*second_best_reduced_cost = *best_reduced_cost;
+		return 0;
+	}
+#ifdef AS_INTEGER_COSTS
+	if (Instance->Packed_edges != NULL)
+		return Instance->Scan_packed(Instance->Packed_edges + offset, Instance->Prices, Instance->price_scale, num_neighbors,
+			best_reduced_cost, second_best_reduced_cost);
+#endif
+	return Instance->Scan(Instance->Persons.is_dense ? NULL : Instance->Persons.neighbors + offset,
+		Instance->Persons.costs + offset, Instance->Prices, Instance->price_scale, num_neighbors,
+		best_reduced_cost, second_best_reduced_cost);
+}
+
+// Version of 'AS_Find_best_object' for dense graphs, which do not store the neighbors: the row 'I' of the matrix of costs
+// is scanned against the whole 'Prices' array, both read linearly, and the position of the best object is its index.
+int		AS_Find_best_object_dense(AuctionSolver *Instance, int I, priceType *gamma, costType *cost_of_best_object)
+{
+	priceType	best_reduced_cost = _INFINITY;
+	priceType	second_best_reduced_cost = _INFINITY;
+	int			best_object = 0;
+	costType	*row = Instance->Persons.costs + (long int)I * Instance->num_objects;
+	
+	if(Instance->num_objects == 1) best_reduced_cost -= 1000000.0;
+	else best_object = Instance->Scan(NULL, row, Instance->Prices, Instance->price_scale, Instance->num_objects,
+		&best_reduced_cost, &second_best_reduced_cost);
+	*cost_of_best_object = row[best_object];
+	*gamma = second_best_reduced_cost - best_reduced_cost;
+	return best_object;
+}
+
+// Version of 'AS_Find_best_object' with the candidate cache (see 'candidate_cache').
+// The prices only decrease during a solve of the forward auction (sequential or parallel), so the reduced costs only grow.
+// Hence the objects that were not among the 'candidate_cache' best ones at the last full scan of the person still have
+// reduced costs of at least 'Candidates_threshold', the best one among them at that moment. If the best and the second
+// best reduced costs among the candidates, with the current prices, are at most this threshold, they are the best and
+// the second best of the whole adjacency list. Otherwise the list is scanned again, keeping the new best objects.
+int		AS_Find_best_object_cached(AuctionSolver *Instance, int I, priceType *gamma, costType *cost_of_best_object)
+{
+	priceType	best_reduced_cost = 0;
+	priceType	second_best_reduced_cost = 0;
+	priceType	reduced_cost = 0;
+	int			num_candidates = Instance->candidate_cache;
+	int			*candidates = Instance->Candidates + (long int)I * Instance->candidates_capacity;
+	//The current reduced costs of the candidates, or the ones found by the full scan in increasing order.
+	priceType	candidate_costs[AS_MAX_CANDIDATES + 1];
+	int			best_k = 0;
+	int			count = 0;
+	int			position = 0;
+	
+	//Try with the candidates. There are always at least two of them.
+	if (Instance->Candidates_valid[I])
+	{
+		candidate_costs[0] = (priceType)Instance->Persons.costs[candidates[0]] * Instance->price_scale
+			- Instance->Prices[Graph_Neighbor(&Instance->Persons, I, candidates[0])];
+		candidate_costs[1] = (priceType)Instance->Persons.costs[candidates[1]] * Instance->price_scale
+			- Instance->Prices[Graph_Neighbor(&Instance->Persons, I, candidates[1])];
+		for(int c = 2; c < num_candidates; ++c)
+			candidate_costs[c] = (priceType)Instance->Persons.costs[candidates[c]] * Instance->price_scale
+				- Instance->Prices[Graph_Neighbor(&Instance->Persons, I, candidates[c])];
+		best_k = (candidate_costs[1] < candidate_costs[0] ? 1 : 0);
+		best_reduced_cost = candidate_costs[best_k];
+		second_best_reduced_cost = candidate_costs[1 - best_k];
+		for(int c = 2; c < num_candidates; ++c)
+		{
+			if (candidate_costs[c] < best_reduced_cost)
+			{
+				second_best_reduced_cost = best_reduced_cost;
+				best_reduced_cost = candidate_costs[c];
+				best_k = c;
+			}
+			else if (candidate_costs[c] < second_best_reduced_cost) second_best_reduced_cost = candidate_costs[c];
+		}
+		best_k = candidates[best_k];
+		if (second_best_reduced_cost <= Instance->Candidates_threshold[I])
+		{
+			*cost_of_best_object = Instance->Persons.costs[best_k];
+			*gamma = second_best_reduced_cost - best_reduced_cost;
+			return Graph_Neighbor(&Instance->Persons, I, best_k);
+		}
+	}
+	
+	//Full scan: keep the 'num_candidates + 1' best positions in increasing order of reduced cost, by insertion.
+	for(int k = Instance->Persons.offsets[I]; k < Instance->Persons.offsets[I + 1]; ++k)
+	{
+		reduced_cost = (priceType)Instance->Persons.costs[k] * Instance->price_scale - Instance->Prices[Graph_Neighbor(&Instance->Persons, I, k)];
+		if (count == num_candidates + 1 && reduced_cost >= candidate_costs[num_candidates]) continue;
+		position = (count == num_candidates + 1 ? num_candidates : count++);
+		for(; position > 0 && candidate_costs[position - 1] > reduced_cost; --position)
+		{
+			candidate_costs[position] = candidate_costs[position - 1];
+			if (position < num_candidates) candidates[position] = candidates[position - 1];
+		}
+		candidate_costs[position] = reduced_cost;
+		if (position < num_candidates) candidates[position] = k;
+	}
+	//The last one is not a candidate, it is the threshold.
+	Instance->Candidates_threshold[I] = candidate_costs[num_candidates];
+	Instance->Candidates_valid[I] = 1;
+	*cost_of_best_object = Instance->Persons.costs[candidates[0]];
+	*gamma = candidate_costs[1] - candidate_costs[0];
+	return Graph_Neighbor(&Instance->Persons, I, candidates[0]);
+}
+
+// Compare the best real object of a person with 'num_neighbors' neighbors, 'best_object', with the dummy objects
+// (see 'num_dummies'), which are adjacent to every person with cost '0'. All the dummies are alike, so only the two of
+// them with the smallest reduced costs '-Prices[j]', the top of 'Dummy_heap', can be the best or the second best options.
+// The best of all the options is returned, and 'gamma' and 'cost_of_best_object' are updated by reference.
+int		AS_Find_best_dummy(AuctionSolver *Instance, int num_neighbors, int best_object, priceType *gamma, costType *cost_of_best_object)
+{
+	BinaryHeap	*Heap = &Instance->Dummy_heap;
+	priceType	best_reduced_cost = NO_OPTION;
+	priceType	second_best_reduced_cost = NO_OPTION;
+	priceType	dummy_reduced_cost = Heap->keys[0];
+	priceType	second_dummy_reduced_cost = (Heap->length > 1 ? Heap->keys[BH_Second_position(Heap)] : NO_OPTION);
+	
+	if (num_neighbors > 0)
+	{
+		best_reduced_cost = (priceType)*cost_of_best_object * Instance->price_scale - Instance->Prices[best_object];
+		if (num_neighbors > 1) second_best_reduced_cost = best_reduced_cost + *gamma;
+	}
+	
+	//The real object wins the ties.
+	if (num_neighbors > 0 && best_reduced_cost <= dummy_reduced_cost)
+	{
+		if (dummy_reduced_cost < second_best_reduced_cost) second_best_reduced_cost = dummy_reduced_cost;
+	}
+	else
+	{
+		second_best_reduced_cost = (best_reduced_cost < second_dummy_reduced_cost ? best_reduced_cost : second_dummy_reduced_cost);
+		best_reduced_cost = dummy_reduced_cost;
+		best_object = Heap->elements[0];
+		*cost_of_best_object = 0;
+	}
+	
+	//With only one option, as in 'AS_Find_best_object', 'gamma' is 1000000.0.
+	*gamma = (second_best_reduced_cost == NO_OPTION ? 1000000.0 : second_best_reduced_cost - best_reduced_cost);
+	return best_object;
+}
+
+// Given the index 'I' of an unmatched person, this function finds the index of the object that has the best_reduced_cost,
+// the edge cost with this object, and the value of 'gamma' which is the difference 'second_best_reduced_cost - best_reduced_cost'.
+// The first is returned as a regular return value and the other two are returned by reference.
+// The adjacency list is scanned by the kernel in 'Scan' (see "reducedcosts.h"). The dummy objects are not considered,
+// and a person without neighbors gets UNMATCHED.
+int		AS_Find_best_real_object(AuctionSolver *Instance, int I, priceType *gamma, costType *cost_of_best_object)
+{
+	//The smallest and the second smallest losses with very big values.
+	priceType	best_reduced_cost = _INFINITY;
+	priceType	second_best_reduced_cost = _INFINITY;
+	
+	//The variable we will return.
+	int			best_object = UNMATCHED;
+	//The position of the best object in the adjacency list.
+	int			best_k = 0;
+	//The adjacency list of the person "I".
+	int			num_neighbors = 0;
+	int			*neighbors;
+	costType	*costs;
+	
+	num_neighbors = Instance->Persons.offsets[I + 1] - Instance->Persons.offsets[I];
+	//The persons with many neighbors use the candidate cache, if enabled.
+	if (num_neighbors == 0) *gamma = 0;
+	else if (Instance->candidate_cache >= 2 && Instance->reverse_switch <= 0 && num_neighbors > 2 * Instance->candidate_cache)
+		best_object = AS_Find_best_object_cached(Instance, I, gamma, cost_of_best_object);
+	//Dense graphs do not store the neighbors.
+	else if (Instance->Persons.neighbors == NULL) best_object = AS_Find_best_object_dense(Instance, I, gamma, cost_of_best_object);
+	else
+	{
+		neighbors = Instance->Persons.neighbors + Instance->Persons.offsets[I];
+		costs = Instance->Persons.costs + Instance->Persons.offsets[I];
+		
+		//See if the person has only one neighbor.
+		if(num_neighbors == 1)
+		{
+			best_object = neighbors[0];
+			*cost_of_best_object = costs[0];
+			//Assign a value to "best_reduced_cost" so that gamma==1000000.0.
+			best_reduced_cost -= 1000000.0;
+		}
+		else
+		{
+			best_k = AS_Scan_person(Instance, I, &best_reduced_cost, &second_best_reduced_cost);
+#ifdef AS_INTEGER_COSTS
+			//With packed edges the unpacked arrays are not read at all.
+			if (Instance->Packed_edges != NULL)
+			{
+				best_object = RC_PACKED_NEIGHBOR(Instance->Packed_edges[Instance->Persons.offsets[I] + best_k]);
+				*cost_of_best_object = RC_PACKED_COST(Instance->Packed_edges[Instance->Persons.offsets[I] + best_k]);
+			}
+			else
+#endif
+			{
+				best_object = neighbors[best_k];
+				*cost_of_best_object = costs[best_k];
+			}
+		}
+		
+		//Compute the bidding difference "gamma".
+		*gamma = second_best_reduced_cost - best_reduced_cost;
+	}
+	
+	//Return the index of the best object.
+	return best_object;
+}
+
+// Version of 'AS_Find_best_real_object' that also considers the dummy objects, if there are (see 'AS_Find_best_dummy').
+int		AS_Find_best_object(AuctionSolver *Instance, int I, priceType *gamma, costType *cost_of_best_object)
+{
+	int		best_object = AS_Find_best_real_object(Instance, I, gamma, cost_of_best_object);
+	
+	if (Instance->num_dummies > 0)
+		best_object = AS_Find_best_dummy(Instance, Instance->Persons.offsets[I + 1] - Instance->Persons.offsets[I], best_object,
+			gamma, cost_of_best_object);
+	return best_object;
+}
+
+// The reverse version of 'AS_Find_best_object': given the index 'J' of an unmatched object, this function finds the
+// index of the person that has the best reduced cost 'price_scale * cost - Profits[i]' seen from the object, the edge
+// cost with this person, and the value of 'gamma', the difference between the second best and the best reduced costs.
+int		AS_Find_best_person(AuctionSolver *Instance, int J, priceType *gamma, costType *cost_of_best_person)
+{
+	priceType	best_reduced_cost = _INFINITY;
+	priceType	second_best_reduced_cost = _INFINITY;
+	int			best_person = UNMATCHED;
+	int			best_k = 0;
+	//The adjacency list of the object "J".
+	//In dense graphs the neighbors are all the persons in order, and they are not stored.
+	int			num_neighbors = Instance->Objects.offsets[J + 1] - Instance->Objects.offsets[J];
+	int			*neighbors = (Instance->Objects.neighbors != NULL ? Instance->Objects.neighbors + Instance->Objects.offsets[J] : NULL);
+	costType	*costs = Instance->Objects.costs + Instance->Objects.offsets[J];
+	
+	//See if the object has only one neighbor.
+	if(num_neighbors == 1)
+	{
+		best_person = (neighbors != NULL ? neighbors[0] : 0);
+		*cost_of_best_person = costs[0];
+		best_reduced_cost -= 1000000.0;
+	}
+	else
+	{
+		best_k = Instance->Scan(neighbors, costs, Instance->Profits, Instance->price_scale,
+			num_neighbors, &best_reduced_cost, &second_best_reduced_cost);
+		best_person = (neighbors != NULL ? neighbors[best_k] : best_k);
+		*cost_of_best_person = costs[best_k];
+	}
+	
+	*gamma = second_best_reduced_cost - best_reduced_cost;
+	return best_person;
+}
+
+#ifdef AS_STATS
+// Record in 'Stats' a bid that scanned 'num_neighbors' neighbors, changed a price by 'increment' and evicted a mate
+// if 'eviction' is '1'.
+void	AS_Stats_Bid(AuctionSolver *Instance, int num_neighbors, priceType increment, priceType epsilon, int eviction)
+{
+	int		bucket = 0;
+	
+	Instance->Stats.neighbors_scanned += num_neighbors;
+	Instance->Stats.evictions += eviction;
+	for(priceType limit = 2 * epsilon; increment >= limit && bucket < AS_STATS_BUCKETS - 1; limit *= 2) ++bucket;
+	++Instance->Stats.increments[bucket];
+}
+#endif
+
+// Name of a queue policy, for reporting.
+const char	*AS_Queue_policy_name(int policy)
+{
+	switch (policy)
+	{
+		case AS_QUEUE_FIFO: return "fifo";
+		case AS_QUEUE_EVICTED_FIRST: return "evicted";
+		case AS_QUEUE_PRICE: return "price";
+		case AS_QUEUE_DEGREE: return "degree";
+		default: return "lifo";
+	}
+}
+
+// The 'AS_QUEUE_*' value of a queue policy given its name, or '-1' if there is no policy with that name.
+int		AS_Queue_policy_from_name(const char *name)
+{
+	for (int policy = AS_QUEUE_LIFO; policy <= AS_QUEUE_DEGREE; ++policy)
+		if (strcmp(name, AS_Queue_policy_name(policy)) == 0) return policy;
+	return -1;
+}
+
+// The price of the dummy object 'J', the top of 'Dummy_heap', has decreased: move it to its new place in the heap.
+void	AS_Update_dummy(AuctionSolver *Instance, int J)
+{
+	int		top = 0;
+	
+	BH_Pop(&Instance->Dummy_heap, &top);
+	BH_Push(&Instance->Dummy_heap, J, -Instance->Prices[J]);
+}
+
+// Given 'epsilon', find a matching and prices that satisfy the epsilon-CS condition.
+// The unmatched persons bid one at a time, in the order given by 'queue_policy'.
+void	AS_eOpt_Matching(AuctionSolver *Instance, priceType epsilon)
+{
+	//A person.
+	int			I = 0;
+	//The bidding difference.
+	priceType	gamma = 0;
+	//The best option for a person.
+	int			best_object = 0;
+	//The cost of the best object.
+	costType	cost_of_best_object = 0;
+	//The person evicted by the bid.
+	int			evicted = 0;
+	int			policy = Instance->queue_policy;
+	BoundedDeque	*Deque = &Instance->Unmatched_persons;
+	BinaryHeap		*Heap = &Instance->Unmatched_heap;
+	
+	//The priority policies move the unmatched persons to the heap. With AS_QUEUE_PRICE they have the key '0', so the
+	//evicted persons go before them, since the prices start at '0' and only decrease.
+	if (policy == AS_QUEUE_PRICE || policy == AS_QUEUE_DEGREE)
+	{
+		BH_Reset(Heap);
+		while(Deque->length > 0)
+		{
+			BD_Pop_Front(Deque, &I);
+			BH_Push(Heap, I, policy == AS_QUEUE_DEGREE ? Instance->Persons.offsets[I + 1] - Instance->Persons.offsets[I] : 0);
+		}
+	}
+	
+	//While we have unmatched persons.
+	while(Deque->length > 0 || Heap->length > 0)
+	{
+		//Get an unmatched person "I".
+		if (Heap->length > 0) BH_Pop(Heap, &I);
+		else if (policy == AS_QUEUE_LIFO) BD_Pop_Back(Deque, &I);
+		else BD_Pop_Front(Deque, &I);
+		
+		//Get the best option for person "I", the bidding increment and the cost of the chosen edge.
+		best_object = AS_Find_best_object(Instance, I, &gamma, &cost_of_best_object);
+		++Instance->num_bids;
+		AS_STAT(AS_Stats_Bid(Instance, Instance->Persons.offsets[I + 1] - Instance->Persons.offsets[I], gamma + epsilon,
+			epsilon, Instance->Matching[best_object] != UNMATCHED));
+		
+		//Update (decrease) the price of the object.
+		Instance->Prices[best_object] -= (gamma + epsilon);
+		if (best_object >= Instance->num_objects) AS_Update_dummy(Instance, best_object);
+		
+		//If the chosen object is matched, then insert its matching in the unmatched persons.
+		evicted = Instance->Matching[best_object];
+		if (evicted != UNMATCHED)
+		{
+			if (policy == AS_QUEUE_PRICE) BH_Push(Heap, evicted, Instance->Prices[best_object]);
+			else if (policy == AS_QUEUE_DEGREE)
+				BH_Push(Heap, evicted, Instance->Persons.offsets[evicted + 1] - Instance->Persons.offsets[evicted]);
+			else if (policy == AS_QUEUE_EVICTED_FIRST) BD_Push_Front(Deque, evicted);
+			else BD_Push_Back(Deque, evicted);
+		}
+		
+		//Update the matching and the costs of the matching.
+		Instance->Matching[best_object] = I;
+		Instance->Matching_costs[best_object] = cost_of_best_object;
+	}
+}
+
+// Returns '1' if the person 'I', matched to the object 'J' with an edge of cost 'cost', satisfies the epsilon-CS
+// condition, i.e. if the reduced cost of that edge is at most 'epsilon' above the best reduced cost of the person.
+// The object 'J' can be a dummy object, with cost '0'.
+int		AS_Satisfies_eCS(AuctionSolver *Instance, int I, int J, costType cost, priceType epsilon)
+{
+	priceType	best_reduced_cost = NO_OPTION;
+	priceType	second_best_reduced_cost = NO_OPTION;
+	int			num_neighbors = Instance->Persons.offsets[I + 1] - Instance->Persons.offsets[I];
+	
+	//A person with only one option has no better option.
+	if (num_neighbors < 2 && Instance->num_dummies == 0) return 1;
+	if (num_neighbors > 0) AS_Scan_person(Instance, I, &best_reduced_cost, &second_best_reduced_cost);
+	if (Instance->num_dummies > 0 && Instance->Dummy_heap.keys[0] < best_reduced_cost) best_reduced_cost = Instance->Dummy_heap.keys[0];
+	
+	return (priceType)cost * Instance->price_scale - Instance->Prices[J] <= best_reduced_cost + epsilon;
+}
+
+// Prepare the next scaling phase keeping the current matching (warm start): the persons whose matched pairs
+// violate the epsilon-CS condition for the new 'epsilon' are unmatched and added to the list of unmatched persons.
+// The rest of the pairs are kept, since the prices only decrease inside a phase and the pairs will still
+// satisfy the condition unless their objects are taken by other persons.
+void	AS_Keep_eCS_pairs(AuctionSolver *Instance, priceType epsilon)
+{
+	int		person_i = 0;
+	
+	for(int object_j = 0; object_j < Instance->num_objects + Instance->num_dummies; ++object_j)
+	{
+		person_i = Instance->Matching[object_j];
+		if (person_i == UNMATCHED) continue;
+		if (!AS_Satisfies_eCS(Instance, person_i, object_j, Instance->Matching_costs[object_j], epsilon))
+		{
+			Instance->Matching[object_j] = UNMATCHED;
+			BD_Push_Back(&Instance->Unmatched_persons, person_i);
+		}
+	}
+}
+
+// Prepare a scaling phase of the combined forward/reverse auction from the current matching in 'Matching':
+// set the mates of the persons, fill the deques of unmatched persons and objects, and set the profits so that
+// the epsilon-CS condition holds, i.e. 'Profits[i]' is the reduced cost of the mate of 'i' if it has one,
+// and its best reduced cost otherwise.
+void	AS_Prepare_forward_reverse(AuctionSolver *Instance)
+{
+	int			person_i = 0;
+	int			best_object = 0;
+	priceType	gamma = 0;
+	costType	cost_of_best_object = 0;
+	
+	BD_Reset(&Instance->Unmatched_persons);
+	BD_Reset(&Instance->Unmatched_objects);
+	for(person_i = 0; person_i < Instance->num_persons; ++person_i)
+		Instance->Assigned_objects[person_i] = UNMATCHED;
+	for(int object_j = 0; object_j < Instance->num_objects; ++object_j)
+	{
+		person_i = Instance->Matching[object_j];
+		Instance->Queued_objects[object_j] = (person_i == UNMATCHED);
+		if (person_i == UNMATCHED) BD_Push_Back(&Instance->Unmatched_objects, object_j);
+		else
+		{
+			Instance->Assigned_objects[person_i] = object_j;
+			Instance->Profits[person_i] = (priceType)Instance->Matching_costs[object_j] * Instance->price_scale - Instance->Prices[object_j];
+		}
+	}
+	for(person_i = 0; person_i < Instance->num_persons; ++person_i)
+	{
+		Instance->Queued_persons[person_i] = (Instance->Assigned_objects[person_i] == UNMATCHED);
+		if (Instance->Assigned_objects[person_i] != UNMATCHED) continue;
+		BD_Push_Back(&Instance->Unmatched_persons, person_i);
+		best_object = AS_Find_best_object(Instance, person_i, &gamma, &cost_of_best_object);
+		Instance->Profits[person_i] = (priceType)cost_of_best_object * Instance->price_scale - Instance->Prices[best_object];
+	}
+}
+
+// Given 'epsilon', find a matching, prices and profits that satisfy the epsilon-CS condition, with the combined
+// forward/reverse auction: unmatched persons bid for objects lowering their prices (forward) and unmatched objects
+// bid for persons lowering their profits (reverse). The direction changes each time 'reverse_switch' new pairs are
+// matched, which avoids long price wars when many persons compete for a few objects.
+// 'AS_Prepare_forward_reverse' must be called before.
+void	AS_eOpt_Matching_Forward_reverse(AuctionSolver *Instance, priceType epsilon)
+{
+	int			num_unmatched = Instance->Unmatched_persons.length;
+	int			target = 0;
+	int			forward = 1;
+	int			I = 0;
+	int			J = 0;
+	int			mate = 0;
+	priceType	gamma = 0;
+	costType	cost = 0;
+	
+	while(num_unmatched > 0)
+	{
+		//Number of unmatched vertices at which the direction changes.
+		target = num_unmatched - Instance->reverse_switch;
+		if (target < 0) target = 0;
+		
+		if (forward)
+			while(num_unmatched > target && Instance->Unmatched_persons.length > 0)
+			{
+				//Get an unmatched person "I", skipping the ones matched by the reverse auction.
+				BD_Pop_Back(&Instance->Unmatched_persons, &I);
+				Instance->Queued_persons[I] = 0;
+				if (Instance->Assigned_objects[I] != UNMATCHED) continue;
+				
+				J = AS_Find_best_object(Instance, I, &gamma, &cost);
+				++Instance->num_bids;
+				mate = Instance->Matching[J];
+				AS_STAT(AS_Stats_Bid(Instance, Instance->Persons.offsets[I + 1] - Instance->Persons.offsets[I], gamma + epsilon,
+					epsilon, mate != UNMATCHED));
+				//The mate of the object becomes unmatched, or the number of pairs grows.
+				if (mate != UNMATCHED)
+				{
+					Instance->Assigned_objects[mate] = UNMATCHED;
+					if (!Instance->Queued_persons[mate])
+					{
+						Instance->Queued_persons[mate] = 1;
+						BD_Push_Back(&Instance->Unmatched_persons, mate);
+					}
+				}
+				else --num_unmatched;
+				
+				Instance->Matching[J] = I;
+				Instance->Assigned_objects[I] = J;
+				Instance->Matching_costs[J] = cost;
+				Instance->Prices[J] -= (gamma + epsilon);
+				Instance->Profits[I] = (priceType)cost * Instance->price_scale - Instance->Prices[J];
+			}
+		else
+			while(num_unmatched > target && Instance->Unmatched_objects.length > 0)
+			{
+				//Get an unmatched object "J", skipping the ones matched by the forward auction.
+				BD_Pop_Back(&Instance->Unmatched_objects, &J);
+				Instance->Queued_objects[J] = 0;
+				if (Instance->Matching[J] != UNMATCHED) continue;
+				
+				I = AS_Find_best_person(Instance, J, &gamma, &cost);
+				++Instance->num_bids;
+				mate = Instance->Assigned_objects[I];
+				AS_STAT(AS_Stats_Bid(Instance, Instance->Objects.offsets[J + 1] - Instance->Objects.offsets[J], gamma + epsilon,
+					epsilon, mate != UNMATCHED));
+				//The mate of the person becomes unmatched, or the number of pairs grows.
+				if (mate != UNMATCHED)
+				{
+					Instance->Matching[mate] = UNMATCHED;
+					if (!Instance->Queued_objects[mate])
+					{
+						Instance->Queued_objects[mate] = 1;
+						BD_Push_Back(&Instance->Unmatched_objects, mate);
+					}
+				}
+				else --num_unmatched;
+				
+				Instance->Matching[J] = I;
+				Instance->Assigned_objects[I] = J;
+				Instance->Matching_costs[J] = cost;
+				Instance->Profits[I] -= (gamma + epsilon);
+				Instance->Prices[J] = (priceType)cost * Instance->price_scale - Instance->Profits[I];
+			}
+		
+		forward = !forward;
+	}
+}
+
+// Argument of the task that computes the bids of a round of the parallel auction.
+typedef struct
+{
+	AuctionSolver	*Instance;
+	priceType		epsilon;
+	int				num_bidders;
+	// The first bid of each thread and the end of the bids after the last one (see 'AS_Group_bidders'), or NULL to split
+	// the bids in equal shares by their position.
+	int				*Thread_bids;
+} AS_Bids_task_arg;
+
+// Task run by each thread of the pool: compute the bids of its share of the persons in 'Bidders'.
+// The prices are only read, so the threads do not need to synchronize.
+void	AS_Compute_bids_task(void *arg, int thread_i, int num_threads)
+{
+	AuctionSolver	*Instance = ((AS_Bids_task_arg*) arg)->Instance;
+	priceType		epsilon = ((AS_Bids_task_arg*) arg)->epsilon;
+	int				num_bidders = ((AS_Bids_task_arg*) arg)->num_bidders;
+	int				*Thread_bids = ((AS_Bids_task_arg*) arg)->Thread_bids;
+	int				first = (Thread_bids != NULL ? Thread_bids[thread_i] : (int)((long int)num_bidders * thread_i / num_threads));
+	int				last = (Thread_bids != NULL ? Thread_bids[thread_i + 1] : (int)((long int)num_bidders * (thread_i + 1) / num_threads));
+	priceType		gamma = 0;
+	//The best reduced cost of the real objects of the bidder, 'NO_OPTION' if it has none.
+	priceType		real_reduced_cost = NO_OPTION;
+	int				best_object = 0;
+	int				num_neighbors = 0;
+	
+	for(int bid_k = first; bid_k < last; ++bid_k)
+	{
+		best_object = AS_Find_best_real_object(Instance, Instance->Bidders[bid_k], &gamma, &Instance->Bid_costs[bid_k]);
+		if (Instance->num_dummies > 0)
+		{
+			num_neighbors = Instance->Persons.offsets[Instance->Bidders[bid_k] + 1] - Instance->Persons.offsets[Instance->Bidders[bid_k]];
+			real_reduced_cost = (num_neighbors > 0 ? (priceType)Instance->Bid_costs[bid_k] * Instance->price_scale
+				- Instance->Prices[best_object] : NO_OPTION);
+			best_object = AS_Find_best_dummy(Instance, num_neighbors, best_object, &gamma, &Instance->Bid_costs[bid_k]);
+		}
+		Instance->Bid_objects[bid_k] = best_object;
+		if (best_object >= Instance->num_objects) Instance->Bid_prices[bid_k] = real_reduced_cost;
+		else Instance->Bid_prices[bid_k] = Instance->Prices[best_object] - (gamma + epsilon);
+	}
+}
+
+// Assign a dummy object to the bid 'bid_k' of the parallel auction, which was for a dummy object. The dummy objects are
+// alike, so the bids for them do not compete for a single object as the bids for the real ones, they are assigned one
+// after the other to the top of 'Dummy_heap' as in the sequential auction. The second best option of the bidder is
+// the best of the real objects, with the reduced cost of the beginning of the round ('Bid_prices[bid_k]') which can
+// only be lower, or the next dummy object. If the top dummy object is already worse than the best real object, the
+// bid is lost. A bidder without real objects ('NO_OPTION') always takes the top dummy object.
+void	AS_Assign_dummy_bid(AuctionSolver *Instance, int bid_k, priceType epsilon)
+{
+	BinaryHeap	*Heap = &Instance->Dummy_heap;
+	priceType	dummy_reduced_cost = Heap->keys[0];
+	priceType	second_best_reduced_cost = Instance->Bid_prices[bid_k];
+	priceType	gamma = 0;
+	int			J = 0;
+	
+	if (second_best_reduced_cost != NO_OPTION && dummy_reduced_cost > second_best_reduced_cost)
+	{
+		BD_Push_Back(&Instance->Unmatched_persons, Instance->Bidders[bid_k]);
+		return;
+	}
+	BH_Pop(Heap, &J);
+	if (Heap->length > 0 && Heap->keys[0] < second_best_reduced_cost) second_best_reduced_cost = Heap->keys[0];
+	gamma = (second_best_reduced_cost == NO_OPTION ? 1000000.0 : second_best_reduced_cost - dummy_reduced_cost);
+	AS_STAT(AS_Stats_Bid(Instance, 0, gamma + epsilon, epsilon, Instance->Matching[J] != UNMATCHED));
+	Instance->Prices[J] -= (gamma + epsilon);
+	BH_Push(Heap, J, -Instance->Prices[J]);
+	
+	if(Instance->Matching[J] != UNMATCHED) BD_Push_Back(&Instance->Unmatched_persons, Instance->Matching[J]);
+	Instance->Matching[J] = Instance->Bidders[bid_k];
+	Instance->Matching_costs[J] = 0;
+}
+
+// Group the 'num_bidders' persons of 'Bidders' by the thread that placed their adjacency lists (see 'AS_Place_memory'),
+// the one whose range of persons contains them, keeping their order inside each group. 'Thread_bids' gets the first bid
+// of each thread and the end of the bids after the last one, so each thread reads the graph from the memory of its node.
+// 'Bid_objects' is used as scratch, since it is written by the bids afterwards.
+void	AS_Group_bidders(AuctionSolver *Instance, int num_bidders, int *Thread_bids)
+{
+	int		num_threads = Instance->Workers.num_threads;
+	int		owner = 0;
+	
+	//Count the bidders of each thread, and turn the counts into the beginnings of the groups.
+	memset(Thread_bids, 0, (num_threads + 1) * sizeof(int));
+	for(int bid_k = 0; bid_k < num_bidders; ++bid_k)
+	{
+		//The last thread whose first person 'num_persons * thread_i / num_threads' is not after the bidder.
+		owner = (int)((((long int)Instance->Bidders[bid_k] + 1) * num_threads - 1) / Instance->num_persons);
+		++Thread_bids[owner + 1];
+	}
+	for(int thread_i = 0; thread_i < num_threads; ++thread_i) Thread_bids[thread_i + 1] += Thread_bids[thread_i];
+	
+	//Place each bidder in its group, which moves the beginning of each group to the end of it.
+	for(int bid_k = 0; bid_k < num_bidders; ++bid_k)
+	{
+		owner = (int)((((long int)Instance->Bidders[bid_k] + 1) * num_threads - 1) / Instance->num_persons);
+		Instance->Bid_objects[Thread_bids[owner]++] = Instance->Bidders[bid_k];
+	}
+	for(int thread_i = num_threads; thread_i > 0; --thread_i) Thread_bids[thread_i] = Thread_bids[thread_i - 1];
+	Thread_bids[0] = 0;
+	memcpy(Instance->Bidders, Instance->Bid_objects, num_bidders * sizeof(int));
+}
+
+// Parallel version of 'AS_eOpt_Matching' (Jacobi auction).
+// In each round all the unmatched persons bid at once, using the prices of the beginning of the round,
+// and the bids are computed by the threads of 'Workers'. Then each object takes its best bid (the lowest
+// price offered), and the persons whose bids lost or who were evicted wait for the next round.
+// The bids for the dummy objects are assigned apart (see 'AS_Assign_dummy_bid'). When the graph was placed on the
+// NUMA nodes, each thread computes the bids of the persons of its own range (see 'AS_Group_bidders').
+void	AS_eOpt_Matching_Parallel(AuctionSolver *Instance, priceType epsilon)
+{
+	AS_Bids_task_arg	task_arg;
+	int					object_j = 0;
+	int					best_bid = 0;
+	int					num_bidders = 0;
+	int					*Thread_bids = NULL;
+	
+	task_arg.Instance = Instance;
+	task_arg.epsilon = epsilon;
+	//Without memory for the groups the bids are split by their position, the placement is only an optimization.
+	if (Instance->numa_placement && Instance->Placement.num_nodes > 1 && Instance->Placed_costs == Instance->Persons.costs
+		&& Instance->Workers.num_threads > 1)
+		Thread_bids = (int*) malloc((Instance->Workers.num_threads + 1) * sizeof(int));
+	
+	//While we have unmatched persons.
+	while(Instance->Unmatched_persons.length > 0)
+	{
+		//All the unmatched persons bid in this round.
+		num_bidders = 0;
+		while(Instance->Unmatched_persons.length > 0)
+			BD_Pop_Back(&Instance->Unmatched_persons, &Instance->Bidders[num_bidders++]);
+		
+		//Compute the bids.
+		task_arg.num_bidders = num_bidders;
+		Instance->num_bids += num_bidders;
+		task_arg.Thread_bids = NULL;
+		if (num_bidders >= AS_MIN_PARALLEL_BIDS)
+		{
+			if (Thread_bids != NULL)
+			{
+				AS_Group_bidders(Instance, num_bidders, Thread_bids);
+				task_arg.Thread_bids = Thread_bids;
+			}
+			TP_Run(&Instance->Workers, AS_Compute_bids_task, &task_arg);
+		}
+		else AS_Compute_bids_task(&task_arg, 0, 1);
+		
+		//Keep the best bid of each object, the persons with losing bids stay unmatched.
+		for(int bid_k = 0; bid_k < num_bidders; ++bid_k)
+		{
+			AS_STAT(Instance->Stats.neighbors_scanned += Instance->Persons.offsets[Instance->Bidders[bid_k] + 1]
+				- Instance->Persons.offsets[Instance->Bidders[bid_k]]);
+			object_j = Instance->Bid_objects[bid_k];
+			if (object_j >= Instance->num_objects) continue;
+			best_bid = Instance->Best_bids[object_j];
+			if (best_bid == -1) Instance->Best_bids[object_j] = bid_k;
+			else if (Instance->Bid_prices[bid_k] < Instance->Bid_prices[best_bid])
+			{
+				BD_Push_Back(&Instance->Unmatched_persons, Instance->Bidders[best_bid]);
+				Instance->Best_bids[object_j] = bid_k;
+			}
+			else BD_Push_Back(&Instance->Unmatched_persons, Instance->Bidders[bid_k]);
+		}
+		
+		//Assign each object to the person with the best bid, evicting its current mate.
+		for(int bid_k = 0; bid_k < num_bidders; ++bid_k)
+		{
+			object_j = Instance->Bid_objects[bid_k];
+			if (object_j >= Instance->num_objects)
+			{
+				AS_Assign_dummy_bid(Instance, bid_k, epsilon);
+				continue;
+			}
+			if (Instance->Best_bids[object_j] != bid_k) continue;
+			Instance->Best_bids[object_j] = -1;
+			AS_STAT(AS_Stats_Bid(Instance, 0, Instance->Prices[object_j] - Instance->Bid_prices[bid_k], epsilon,
+				Instance->Matching[object_j] != UNMATCHED));
+			
+			if(Instance->Matching[object_j] != UNMATCHED)
+				BD_Push_Back(&Instance->Unmatched_persons, Instance->Matching[object_j]);
+			Instance->Matching[object_j] = Instance->Bidders[bid_k];
+			Instance->Matching_costs[object_j] = Instance->Bid_costs[bid_k];
+			Instance->Prices[object_j] = Instance->Bid_prices[bid_k];
+		}
+	}
+	free((char*) Thread_bids);
+}
+
+// Make sure that the arrays used by 'AS_Solve_Instance' with the current options have room for the current graph.
+// The arrays only grow: when the graph has more persons or objects than the capacity all of them are freed and the
+// capacity grows, and then the missing ones are allocated for the capacity. The content of the arrays is not kept.
+// The arrays of the objects also have room for the dummy objects, which are at most one per person.
+// In case of error, an Error instance will be returned.
+Error	AS_Reserve_memory(AuctionSolver *Instance)
+{
+	Error	error = {1, "OK"};
+	int		has_dummies = (Instance->maximum_cardinality || Instance->num_persons > Instance->num_objects);
+	int		num_slots = Instance->num_objects + (has_dummies ? Instance->num_persons : 0);
+	
+	if (Instance->num_persons > Instance->persons_capacity || num_slots > Instance->objects_capacity)
+	{
+		Delete_array((char**)&Instance->Prices);
+		Delete_array((char**)&Instance->Matching);
+		Delete_array((char**)&Instance->Matching_costs);
+		BD_Clear(&Instance->Unmatched_persons);
+		BH_Clear(&Instance->Unmatched_heap);
+		BH_Clear(&Instance->Dummy_heap);
+		Delete_array((char**)&Instance->Bidders);
+		Delete_array((char**)&Instance->Bid_objects);
+		Delete_array((char**)&Instance->Bid_prices);
+		Delete_array((char**)&Instance->Bid_costs);
+		Delete_array((char**)&Instance->Best_bids);
+		Delete_array((char**)&Instance->Profits);
+		Delete_array((char**)&Instance->Assigned_objects);
+		BD_Clear(&Instance->Unmatched_objects);
+		Delete_array((char**)&Instance->Queued_persons);
+		Delete_array((char**)&Instance->Queued_objects);
+		Delete_array((char**)&Instance->Feasibility_workspace);
+		Delete_array((char**)&Instance->Candidates);
+		Delete_array((char**)&Instance->Candidates_threshold);
+		Delete_array((char**)&Instance->Candidates_valid);
+		if (Instance->num_persons > Instance->persons_capacity) Instance->persons_capacity = Instance->num_persons;
+		if (num_slots > Instance->objects_capacity) Instance->objects_capacity = num_slots;
+	}
+	
+	//Allocate memory for the prices, the matching of the objects, the costs of the matching and the unmatched persons list.
+	if (Instance->Prices == NULL) Allocate_array((char**)&Instance->Prices, Instance->objects_capacity * sizeof(priceType));
+	if (Instance->Matching == NULL) Allocate_array((char**)&Instance->Matching, Instance->objects_capacity * sizeof(int));
+	if (Instance->Matching_costs == NULL) Allocate_array((char**)&Instance->Matching_costs, Instance->objects_capacity * sizeof(costType));
+	if (Instance->Unmatched_persons.container == NULL) BD_AllocateMemory(&Instance->Unmatched_persons, Instance->persons_capacity);
+	if (Instance->Prices == NULL || Instance->Matching == NULL || Instance->Matching_costs == NULL || Instance->Unmatched_persons.container == NULL)
+	{
+		Error_Set(&error, -1, "Error: no memory for the allocation of the auxiliary structures in 'AS_Reserve_memory'.");
+		return error;
+	}
+	
+	//The workspace of the feasibility check, also used to count the dummy objects in the maximum cardinality mode.
+	if ((Instance->check_feasibility || Instance->maximum_cardinality) && Instance->Feasibility_workspace == NULL)
+	{
+		Allocate_array((char**)&Instance->Feasibility_workspace,
+			HK_WORKSPACE_SIZE(Instance->persons_capacity, Instance->objects_capacity) * sizeof(int));
+		if (Instance->Feasibility_workspace == NULL)
+		{
+			Error_Set(&error, -1, "Error: no memory for the feasibility check in 'AS_Reserve_memory'.");
+			return error;
+		}
+	}
 	
-	//Take the beginning time.
-	start_time = My_time();
+	//The heap of the dummy objects.
+	if (has_dummies)
+	{
+		if (Instance->Dummy_heap.elements == NULL) BH_AllocateMemory(&Instance->Dummy_heap, Instance->persons_capacity);
+		if (Instance->Dummy_heap.elements == NULL)
+		{
+			Error_Set(&error, -1, "Error: no memory for the dummy objects in 'AS_Reserve_memory'.");
+			return error;
+		}
+	}
 	
-	//Make sure that the list of unmatched persons is empty.
-	BD_Reset(&Instance->Unmatched_persons);
+	//The memory of the combined forward/reverse auction, also used by the last step of the solve when some objects
+	//are left unmatched (see 'AS_Reverse_unmatched_objects').
+	if (Instance->reverse_switch > 0 || Instance->maximum_cardinality || Instance->num_objects > Instance->num_persons)
+	{
+		if (Instance->Profits == NULL) Allocate_array((char**)&Instance->Profits, Instance->persons_capacity * sizeof(priceType));
+		if (Instance->Assigned_objects == NULL) Allocate_array((char**)&Instance->Assigned_objects, Instance->persons_capacity * sizeof(int));
+		if (Instance->Queued_persons == NULL) Allocate_array((char**)&Instance->Queued_persons, Instance->persons_capacity * sizeof(char));
+		if (Instance->Queued_objects == NULL) Allocate_array((char**)&Instance->Queued_objects, Instance->objects_capacity * sizeof(char));
+		if (Instance->Unmatched_objects.container == NULL) BD_AllocateMemory(&Instance->Unmatched_objects, Instance->objects_capacity);
+		if (Instance->Profits == NULL || Instance->Assigned_objects == NULL || Instance->Queued_persons == NULL
+			|| Instance->Queued_objects == NULL || Instance->Unmatched_objects.container == NULL)
+		{
+			Error_Set(&error, -1, "Error: no memory for the forward/reverse auction in 'AS_Reserve_memory'.");
+			return error;
+		}
+	}
+	
+	//The heap of the priority queue policies.
+	if (Instance->queue_policy == AS_QUEUE_PRICE || Instance->queue_policy == AS_QUEUE_DEGREE)
+	{
+		if (Instance->Unmatched_heap.elements == NULL) BH_AllocateMemory(&Instance->Unmatched_heap, Instance->persons_capacity);
+		if (Instance->Unmatched_heap.elements == NULL)
+		{
+			Error_Set(&error, -1, "Error: no memory for the queue of unmatched persons in 'AS_Reserve_memory'.");
+			return error;
+		}
+	}
+	
+	//The memory of the candidate cache, which grows with the number of candidates too.
+	if (Instance->candidate_cache > AS_MAX_CANDIDATES) Instance->candidate_cache = AS_MAX_CANDIDATES;
+	if (Instance->candidate_cache >= 2 && Instance->reverse_switch <= 0)
+	{
+		if (Instance->candidate_cache > Instance->candidates_capacity) Delete_array((char**)&Instance->Candidates);
+		if (Instance->Candidates == NULL)
+		{
+			if (Instance->candidate_cache > Instance->candidates_capacity) Instance->candidates_capacity = Instance->candidate_cache;
+			Allocate_array((char**)&Instance->Candidates, (long int)Instance->persons_capacity * Instance->candidates_capacity * sizeof(int));
+		}
+		if (Instance->Candidates_threshold == NULL) Allocate_array((char**)&Instance->Candidates_threshold, Instance->persons_capacity * sizeof(priceType));
+		if (Instance->Candidates_valid == NULL) Allocate_array((char**)&Instance->Candidates_valid, Instance->persons_capacity * sizeof(char));
+		if (Instance->Candidates == NULL || Instance->Candidates_threshold == NULL || Instance->Candidates_valid == NULL)
+		{
+			Error_Set(&error, -1, "Error: no memory for the candidate cache in 'AS_Reserve_memory'.");
+			return error;
+		}
+	}
+	
+	//The memory for the rounds of bids of the parallel auction.
+	if (Instance->num_threads > 1)
+	{
+		if (Instance->Bidders == NULL) Allocate_array((char**)&Instance->Bidders, Instance->persons_capacity * sizeof(int));
+		if (Instance->Bid_objects == NULL) Allocate_array((char**)&Instance->Bid_objects, Instance->persons_capacity * sizeof(int));
+		if (Instance->Bid_prices == NULL) Allocate_array((char**)&Instance->Bid_prices, Instance->persons_capacity * sizeof(priceType));
+		if (Instance->Bid_costs == NULL) Allocate_array((char**)&Instance->Bid_costs, Instance->persons_capacity * sizeof(costType));
+		if (Instance->Best_bids == NULL) Allocate_array((char**)&Instance->Best_bids, Instance->objects_capacity * sizeof(int));
+		if (Instance->Bidders == NULL || Instance->Bid_objects == NULL || Instance->Bid_prices == NULL || Instance->Bid_costs == NULL || Instance->Best_bids == NULL)
+		{
+			Error_Set(&error, -1, "Error: no memory for the allocation of the bids in 'AS_Reserve_memory'.");
+			return error;
+		}
+	}
+	
+	return error;
+}
+
+// Argument of the tasks of 'AS_Place_memory'.
+typedef struct
+{
+	AuctionSolver	*Instance;
+	// The copy of the graph whose pages each thread touches first.
+	Graph			*Placed;
+} AS_Placement_task_arg;
+
+// Task run by each thread of the pool: pin the thread to its CPU, and copy the adjacency lists of its range of persons
+// to 'Placed', the same range of persons that it is given in the first touch.
+void	AS_Place_memory_task(void *arg, int thread_i, int num_threads)
+{
+	AuctionSolver	*Instance = ((AS_Placement_task_arg*) arg)->Instance;
+	Graph			*Placed = ((AS_Placement_task_arg*) arg)->Placed;
+	Graph			*Persons = &Instance->Persons;
+	int				first = (int)((long int)Persons->num_persons * thread_i / num_threads);
+	int				last = (int)((long int)Persons->num_persons * (thread_i + 1) / num_threads);
+	int				begin = 0;
+	int				end = 0;
+	
+	NP_Pin_thread(&Instance->Placement, thread_i);
+	if (Placed == NULL) return;
+	begin = Persons->offsets[first];
+	end = Persons->offsets[last];
+	memcpy(Placed->offsets + first + 1, Persons->offsets + first + 1, (last - first) * sizeof(int));
+	if (Persons->neighbors != NULL) memcpy(Placed->neighbors + begin, Persons->neighbors + begin, (long int)(end - begin) * sizeof(int));
+	memcpy(Placed->costs + begin, Persons->costs + begin, (long int)(end - begin) * sizeof(costType));
+}
+
+// Place the threads and the memory of the parallel auction on the NUMA nodes (see 'numa_placement'). The threads are
+// pinned to their CPUs. On a machine with several nodes, the graph is copied to new arrays by the threads, each one the
+// adjacency lists of a range of persons, so each page of the graph is in the memory of the node of the thread that
+// touched it first, and then each thread computes the bids of the persons of its range (see 'AS_Group_bidders'); and the
+// prices and the best bids of the objects, read by all the threads, are interleaved over the nodes. The calling thread
+// is pinned too, until 'NP_Restore_caller'. The placement is reported in 'Placement'.
+// If the graph can not be copied it is left where it is, the placement is only an optimization.
+void	AS_Place_memory(AuctionSolver *Instance)
+{
+	AS_Placement_task_arg	task_arg;
+	Graph					Placed;
+	NumaPlacement			*NP = &Instance->Placement;
+	int						num_threads = Instance->Workers.num_threads;
+	
+	if (NP_Plan(NP, num_threads).code == -1) return;
+	task_arg.Instance = Instance;
+	task_arg.Placed = NULL;
+	Graph_Defaults(&Placed);
+	if (NP->num_nodes > 1 && Instance->Persons.costs != Instance->Placed_costs
+		&& Graph_Allocate_arrays(&Placed, Instance->num_persons, Instance->Persons.num_edges, Instance->Persons.neighbors != NULL).code == 1)
+		task_arg.Placed = &Placed;
+	TP_Run(&Instance->Workers, AS_Place_memory_task, &task_arg);
+	if (task_arg.Placed != NULL)
+	{
+		Placed.is_dense = Instance->Persons.is_dense;
+		Graph_Clear(&Instance->Persons);
+		Instance->Persons = Placed;
+		Instance->Placed_costs = Placed.costs;
+	}
+	
+	NP->num_pinned = 0;
+	for (int thread_i = 0; thread_i < num_threads; ++thread_i)
+		if (NP->Thread_cpus[thread_i] >= 0) ++NP->num_pinned;
+	NP->interleaved_bytes = NP_Interleave(NP, Instance->Prices, Instance->objects_capacity * sizeof(priceType))
+		+ NP_Interleave(NP, Instance->Best_bids, Instance->objects_capacity * sizeof(int));
+}
+
+// Prepare the solver for the scaling phases of 'AS_Solve_Instance' or 'AS_Resolve_Instance': check the graph, make room
+// in the arrays, check that the graph has a perfect matching, build the graph of the objects if needed, choose the kernel
+// and start the threads. The prices and the matching are not changed.
+// In case of error, an Error instance will be returned.
+Error	AS_Prepare_solve(AuctionSolver *Instance)
+{
+	Error	error = {1, "OK"};
+	
+	//Check for some posible errors.
+	if(Instance->num_persons <= 0 || Instance->num_objects <= 0)
+	{
+		Error_Set(&error, -1, "Error: The graph can not be empty");
+		return error;
+	}
+	if (Instance->reverse_switch > 0 && (Instance->num_persons != Instance->num_objects || Instance->maximum_cardinality))
+	{
+		Error_Set(&error, -1, "Error: The forward/reverse auction needs a balanced graph and a perfect matching");
+		return error;
+	}
+	
+	//MEMORY ALLOCATION, only when the graph is bigger than all the previous ones.
+	error = AS_Reserve_memory(Instance);
+	if (error.code == -1)
+	{
+		strcat(error.msg, " In 'AS_Prepare_solve'");
+		AS_Clear(Instance);
+		return error;
+	}
+	
+	//Check that the graph has a matching that covers its smallest side, otherwise the auction would never end. In the
+	//maximum cardinality mode it is always done, since the size of the maximum matching gives the number of dummy objects.
+	Instance->max_cardinality = -1;
+	if (Instance->check_feasibility || Instance->maximum_cardinality)
+	{
+		error = HK_Maximum_matching(&Instance->Persons, Instance->num_objects, &Instance->max_cardinality, NULL, Instance->Feasibility_workspace);
+		if (error.code == -1)
+		{
+			strcat(error.msg, " In 'AS_Prepare_solve'");
+			return error;
+		}
+		if (!Instance->maximum_cardinality && Instance->max_cardinality < Instance->num_persons
+			&& Instance->max_cardinality < Instance->num_objects)
+		{
+			snprintf(error.msg, sizeof(error.msg), "Error: The graph has no perfect matching, the maximum cardinality matching has %d of %d pairs.",
+				Instance->max_cardinality, (Instance->num_persons < Instance->num_objects ? Instance->num_persons : Instance->num_objects));
+			error.code = -1;
+			return error;
+		}
+	}
+	
+	//The persons that can not be matched take the dummy objects.
+	if (Instance->max_cardinality >= 0) Instance->num_dummies = Instance->num_persons - Instance->max_cardinality;
+	else Instance->num_dummies = (Instance->num_persons > Instance->num_objects ? Instance->num_persons - Instance->num_objects : 0);
+	
+	//Build the graph of the objects for the combined forward/reverse auction, or for the last step of the solve when
+	//some objects are left unmatched.
+	if (Instance->reverse_switch > 0 || Instance->num_objects + Instance->num_dummies > Instance->num_persons)
+	{
+		error = Graph_Transpose(&Instance->Persons, Instance->num_objects, &Instance->Objects);
+		if (error.code == -1)
+		{
+			strcat(error.msg, " In 'AS_Prepare_solve'");
+			AS_Clear(Instance);
+			return error;
+		}
+	}
+	
+	//Choose the kernel that scans the adjacency lists.
+	Instance->Scan = RC_Select_kernel(Instance->max_kernel, &Instance->kernel);
+	
+#ifdef AS_INTEGER_COSTS
+	//Pack the edges for the scan, in each solve since the graph may have changed. The copy is deleted when it is not used.
+	if (Instance->packed_edges && Instance->Persons.neighbors != NULL && !Instance->Persons.is_dense)
+	{
+		if (Instance->Persons.num_edges > Instance->packed_capacity)
+		{
+			Delete_array((char**)&Instance->Packed_edges);
+			Instance->packed_capacity = Instance->Persons.num_edges;
+		}
+		if (Instance->Packed_edges == NULL)
+			Allocate_array((char**)&Instance->Packed_edges, (Instance->packed_capacity + 1) * sizeof(RC_Packed_edge));
+		if (Instance->Packed_edges == NULL)
+		{
+			Instance->packed_capacity = 0;
+			Error_Set(&error, -1, "Error: no memory for the packed edges in 'AS_Prepare_solve'");
+			return error;
+		}
+		for(int k = 0; k < Instance->Persons.num_edges; ++k)
+			Instance->Packed_edges[k] = RC_PACK_EDGE(Instance->Persons.neighbors[k], Instance->Persons.costs[k]);
+		Instance->Scan_packed = RC_Packed_kernel(Instance->kernel);
+	}
+	else
+	{
+		Delete_array((char**)&Instance->Packed_edges);
+		Instance->packed_capacity = 0;
+	}
+#endif
+	
+	//The candidates of the previous solve are not valid, the prices or the graph may have changed.
+	if (Instance->candidate_cache >= 2 && Instance->reverse_switch <= 0)
+		memset(Instance->Candidates_valid, 0, Instance->num_persons * sizeof(char));
+	
+	//Start the threads of the parallel auction.
+	if (Instance->num_threads > 1)
+	{
+		for(int object_i = 0; object_i < Instance->num_objects; ++object_i)
+			Instance->Best_bids[object_i] = -1;
+		
+		error = TP_Create(&Instance->Workers, Instance->num_threads);
+		if (error.code == -1)
+		{
+			strcat(error.msg, " In 'AS_Prepare_solve'");
+			return error;
+		}
+		if (Instance->numa_placement) AS_Place_memory(Instance);
+	}
+	
+	return error;
+}
+
+// Duality gap of the current perfect matching and prices, in units of the prices: the cost of the matching minus the
+// dual value 'sum of the best reduced cost of each person + sum of the prices', which is a lower bound of the cost of
+// any perfect matching. So if the costs are integers and the gap is less than one cost unit, the matching is optimal.
+priceType	AS_Duality_gap(AuctionSolver *Instance)
+{
+	priceType	gap = 0;
+	priceType	best_reduced_cost = 0;
+	priceType	second_best_reduced_cost = 0;
+	
+	for(int object_j = 0; object_j < Instance->num_objects; ++object_j)
+		gap += (priceType)Instance->Matching_costs[object_j] * Instance->price_scale - Instance->Prices[object_j];
+	for(int person_i = 0; person_i < Instance->num_persons; ++person_i)
+	{
+		AS_Scan_person(Instance, person_i, &best_reduced_cost, &second_best_reduced_cost);
+		gap -= best_reduced_cost;
+	}
+	return gap;
+}
+
+// Last step of the solve when there are more objects than persons, so some objects stay unmatched: this is the reverse
+// step of the auction for asymmetric problems of Bertsekas and Castanon. The matching is optimal if the prices of the
+// unmatched objects are not below the biggest price 'top_price' of the matched ones (the prices only decrease). The
+// unmatched objects with lower prices bid for their best persons, or take 'top_price' if no person is worth it, and the
+// objects that lose their persons become unmatched and bid too. The profits of the persons are their reduced costs.
+// The dummy objects never lose their persons: a person matched to a dummy has no unmatched neighbor, since the
+// matching of the real objects is maximum.
+void	AS_Reverse_unmatched_objects(AuctionSolver *Instance, priceType epsilon)
+{
+	BoundedDeque	*Deque = &Instance->Unmatched_objects;
+	priceType		top_price = 0;
+	priceType		best_reduced_cost = 0;
+	priceType		gamma = 0;
+	costType		cost = 0;
+	int				J = 0;
+	int				I = 0;
+	int				old_object = 0;
+	int				num_matched = 0;
+	
+	for(int person_i = 0; person_i < Instance->num_persons; ++person_i) Instance->Assigned_objects[person_i] = UNMATCHED;
+	for(int object_j = 0; object_j < Instance->num_objects + Instance->num_dummies; ++object_j)
+	{
+		I = Instance->Matching[object_j];
+		if (I == UNMATCHED) continue;
+		Instance->Assigned_objects[I] = object_j;
+		Instance->Profits[I] = (priceType)Instance->Matching_costs[object_j] * Instance->price_scale - Instance->Prices[object_j];
+		//The prices can have any size, so 'top_price' starts from the first matched one.
+		if (num_matched++ == 0 || Instance->Prices[object_j] > top_price) top_price = Instance->Prices[object_j];
+	}
+	if (num_matched == 0) return;
+	
+	BD_Reset(Deque);
+	for(int object_j = 0; object_j < Instance->num_objects; ++object_j)
+		if (Instance->Matching[object_j] == UNMATCHED && Instance->Prices[object_j] < top_price) BD_Push_Back(Deque, object_j);
+	
+	while(Deque->length > 0)
+	{
+		BD_Pop_Back(Deque, &J);
+		++Instance->num_bids;
+		if (Instance->Objects.offsets[J + 1] == Instance->Objects.offsets[J])
+		{
+			Instance->Prices[J] = top_price;
+			continue;
+		}
+		I = AS_Find_best_person(Instance, J, &gamma, &cost);
+		best_reduced_cost = (priceType)cost * Instance->price_scale - Instance->Profits[I];
+		if (top_price <= best_reduced_cost + epsilon)
+		{
+			Instance->Prices[J] = top_price;
+			continue;
+		}
+		
+		//The object takes the person, and its old object becomes unmatched.
+		Instance->Prices[J] = (best_reduced_cost + gamma + epsilon < top_price ? best_reduced_cost + gamma + epsilon : top_price);
+		Instance->Profits[I] = (priceType)cost * Instance->price_scale - Instance->Prices[J];
+		old_object = Instance->Assigned_objects[I];
+		Instance->Matching[old_object] = UNMATCHED;
+		Instance->Matching_costs[old_object] = 0;
+		if (Instance->Prices[old_object] < top_price) BD_Push_Back(Deque, old_object);
+		Instance->Matching[J] = I;
+		Instance->Matching_costs[J] = cost;
+		Instance->Assigned_objects[I] = J;
+	}
+}
+
+// Run the scaling phases of the auction: before each phase epsilon is divided by 'alpha', down to 'last_epsilon'
+// (with 'adaptive_epsilon' the factor changes after each phase). Each phase starts from an empty matching, unless
+// 'keep_matching' is '1' (or 'warm_start' is '1', after the first phase), in which case only the pairs that violate
+// the epsilon-CS condition are discarded. The persons that are unmatched before the first phase must be in 'Unmatched_persons'.
+// The trace of the phases is left in 'Phases', and the times of the phases and of the extraction of the result in 'Timings'.
+void	AS_Scaling_phases(AuctionSolver *Instance, priceType epsilon, priceType last_epsilon, double alpha, int keep_matching)
+{
+	//The beginning of the phases, and of the current step.
+	double		start_time = Wall_time();
+	double		step_time = 0;
+	//The number of scaling phases done.
+	int			phase_i = 0;
+	AS_Phase	*Phase;
+	AS_Phase	*Phases;
+	//The factor that divides epsilon, and whether the costs are integers (for the early exit of the adaptive schedule).
+	double		factor = alpha;
+	int			integer_costs = 1;
+	//The duality gap that proves the optimality: below one cost unit. The gap is exact in the integer mode, but with
+	//'double' the prices carry the rounding errors of 'epsilon / factor', so it needs a margin relative to the costs.
+	double		optimal_gap = 1;
+	
+#ifndef AS_INTEGER_COSTS
+	for(int k = 0; k < Instance->Persons.num_edges && Instance->adaptive_epsilon && integer_costs; ++k)
+		integer_costs = (Instance->Persons.costs[k] == (double)(long long)Instance->Persons.costs[k]);
+	optimal_gap = 1 - 1e-9 * (1 + (double)Instance->max_abs_cost * Instance->num_persons);
+#endif
+	
+	//The heap of the dummy objects, from their current prices.
+	if (Instance->num_dummies > 0)
+	{
+		BH_Reset(&Instance->Dummy_heap);
+		for(int slot = Instance->num_objects; slot < Instance->num_objects + Instance->num_dummies; ++slot)
+			BH_Push(&Instance->Dummy_heap, slot, -Instance->Prices[slot]);
+	}
+	
+	Instance->num_phases = 0;
 	do
 	{
 		//Reduce epsilon.
-		epsilon /= alpha;
-		if(epsilon < final_epsilon) epsilon = final_epsilon;
+		epsilon = (priceType)(epsilon / factor);
+		if(epsilon < last_epsilon) epsilon = last_epsilon;
 		
-		//Discard the matching, and add all persons to the list of unmatched persons.
-		for(int object_i = 0; object_i < Instance->num_objects; ++object_i)
-			Instance->Matching[object_i] = UNMATCHED;
-		for(int person_i = 0; person_i < Instance->num_persons; ++person_i)
-			BD_Push_Back(&Instance->Unmatched_persons, person_i);
+		//With warm start only the pairs that violate the epsilon-CS condition are discarded (not in the first phase).
+		if (keep_matching || (Instance->warm_start && phase_i > 0)) AS_Keep_eCS_pairs(Instance, epsilon);
+		else
+		{
+			//Discard the matching, and add all persons to the list of unmatched persons.
+			BD_Reset(&Instance->Unmatched_persons);
+			for(int object_i = 0; object_i < Instance->num_objects + Instance->num_dummies; ++object_i)
+				Instance->Matching[object_i] = UNMATCHED;
+			for(int person_i = 0; person_i < Instance->num_persons; ++person_i)
+				BD_Push_Back(&Instance->Unmatched_persons, person_i);
+		}
+		++phase_i;
+		if (Instance->reverse_switch > 0) AS_Prepare_forward_reverse(Instance);
+		
+		//Start the trace of the phase, making room for it if needed.
+		if (Instance->num_phases == Instance->max_phases)
+		{
+			Phases = (AS_Phase*) realloc(Instance->Phases, (2 * Instance->max_phases + 16) * sizeof(AS_Phase));
+			if (Phases != NULL)
+			{
+				Instance->Phases = Phases;
+				Instance->max_phases = 2 * Instance->max_phases + 16;
+			}
+		}
+		Phase = (Instance->num_phases < Instance->max_phases ? &Instance->Phases[Instance->num_phases++] : NULL);
+		if (Phase != NULL)
+		{
+			Phase->epsilon = (double)epsilon / Instance->price_scale;
+			Phase->unmatched = Instance->Unmatched_persons.length;
+			Phase->bids = Instance->num_bids;
+			Phase->duality_gap = -1;
+		}
+		AS_STAT(memset(&Instance->Stats, 0, sizeof(AS_Stats)));
+		AS_STAT(Instance->Stats.cpu_time = Cpu_time());
+		step_time = Wall_time();
 		
 		//Find an epsilon-optimal matching.
-		AS_eOpt_Matching(Instance, epsilon);
+		if (Instance->reverse_switch > 0) AS_eOpt_Matching_Forward_reverse(Instance, epsilon);
+		else if (Instance->num_threads > 1) AS_eOpt_Matching_Parallel(Instance, epsilon);
+		else AS_eOpt_Matching(Instance, epsilon);
+		if (Phase != NULL)
+		{
+			Phase->bids = Instance->num_bids - Phase->bids;
+			Phase->wall_time = Wall_time() - step_time;
+		}
+		AS_STAT(Instance->Stats.cpu_time = Cpu_time() - Instance->Stats.cpu_time);
+		AS_STAT(if (Phase != NULL) Phase->stats = Instance->Stats);
+		
+		//Choose the next factor from the bids of the phase, unless the matching is already optimal. The duality gap is only
+		//known for perfect matchings.
+		if (Instance->adaptive_epsilon && Phase != NULL && epsilon > last_epsilon
+			&& Instance->num_dummies == 0 && Instance->num_persons == Instance->num_objects)
+		{
+			Phase->duality_gap = (double)AS_Duality_gap(Instance) / Instance->price_scale;
+			if (integer_costs && Phase->duality_gap < optimal_gap) break;
+			if (Phase->bids <= (long int)AS_FEW_BIDS_PER_PERSON * Phase->unmatched) factor *= 2;
+			else if (Phase->bids >= (long int)AS_MANY_BIDS_PER_PERSON * Phase->unmatched) factor /= 2;
+			if (factor < AS_MIN_SCALING_FACTOR) factor = AS_MIN_SCALING_FACTOR;
+			if (factor > AS_MAX_SCALING_FACTOR) factor = AS_MAX_SCALING_FACTOR;
+		}
 	}
-	while(epsilon > final_epsilon);
+	while(epsilon > last_epsilon);
+	step_time = Wall_time();
+	Instance->Timings.phases_time = step_time - start_time;
 	
-	//Get the solving time.
-	Instance->solving_time = (double) (My_time() - start_time) / sysconf(_SC_CLK_TCK);
+	//The objects left unmatched must not be cheaper than the matched ones.
+	if (Instance->num_objects + Instance->num_dummies > Instance->num_persons) AS_Reverse_unmatched_objects(Instance, epsilon);
 	
+	//The dummy objects cost nothing.
 	Instance->matching_cost = 0;
 	for(int object_i = 0; object_i < Instance->num_objects; ++object_i)
+	{
+		if (Instance->Matching[object_i] == UNMATCHED) Instance->Matching_costs[object_i] = 0;
 		Instance->matching_cost += Instance->Matching_costs[object_i];
+	}
+	Instance->Timings.extraction_time = Wall_time() - step_time;
+}
+
+// Find a matching and prices that satisfy the epsilon-CS condition with 'epsilon=final_epsilon'.
+// This is done via the Auction Algorithm, with scaling phases that go from 'epsilon=initial_epsilon'
+// down to 'epsilon=final_epsilon', with a scaling factor of 'alpha'. The values of epsilon are in units of the costs.
+Error	AS_Solve_Instance(AuctionSolver *Instance, double initial_epsilon, double alpha, double final_epsilon)
+{
+	//To get the time.
+	double			start_time = Wall_time();
+	//Error tracker.
+	Error			error = {0, ""};
+	//The epsilon, and the final epsilon, in units of the prices.
+	priceType		epsilon;
+	priceType		last_epsilon;
+	
+	Instance->is_solved = 0;
+	if(initial_epsilon < 0 || final_epsilon < 0)
+	{
+		Error_Set(&error, -1, "Error: The initial and final values for epsilon can not be negative.");
+		return error;
+	}
+	Instance->Timings.presolve_time = 0;
+	error = AS_Prepare_solve(Instance);
+	Instance->Timings.prepare_time = Wall_time() - start_time;
+	if (error.code == -1)
+	{
+		strcat(error.msg, " In 'AS_Solve_Instance'");
+		return error;
+	}
+	
+	for(int object_i = 0; object_i < Instance->num_objects + Instance->num_dummies; ++object_i)
+	{
+		Instance->Prices[object_i] = 0;
+		Instance->Matching_costs[object_i] = 0;
+	}
+	
+#ifdef AS_INTEGER_COSTS
+	//With the costs multiplied by 'num_persons + 1', an epsilon of '1' price unit is already optimal,
+	//so it is the final epsilon if no limit was passed, and the smallest one in any case.
+	Instance->price_scale = Instance->num_persons + 1;
+	epsilon = (priceType)(initial_epsilon * Instance->price_scale);
+	last_epsilon = (priceType)(final_epsilon * Instance->price_scale);
+	if(last_epsilon < 1) last_epsilon = 1;
+#else
+	Instance->price_scale = 1;
+	epsilon = initial_epsilon;
+	//If no limit for epsilon was passed, use an optimal value.
+	if(final_epsilon == 0) final_epsilon = 1.0 / (Instance->num_persons + 2.0);
+	last_epsilon = final_epsilon;
+#endif
+	
+	AS_Scaling_phases(Instance, epsilon, last_epsilon, alpha, 0);
+	NP_Restore_caller(&Instance->Placement);
+	
+	//Get the solving time.
+	Instance->solving_time = Instance->Timings.phases_time + Instance->Timings.extraction_time;
+	Instance->is_solved = 1;
+	
+	Error_Set(&error, 1, "OK");
+	return error;
+}
+
+// Solve again the instance after some changes of its edges ('AS_Update_cost', 'AS_Add_edge', 'AS_Remove_edge'),
+// starting from the prices and the matching of the previous solve instead of from zero prices. Only the persons
+// whose pairs violate the epsilon-CS condition, or whose edges were removed, are unmatched, so after small changes
+// of the costs only a few persons bid. The parameters are those of 'AS_Solve_Instance', but 'initial_epsilon' only
+// needs to be about the biggest change of a cost (with '0' a single phase with the final epsilon is done).
+// In case of error, an Error instance will be returned.
+Error	AS_Resolve_Instance(AuctionSolver *Instance, double initial_epsilon, double alpha, double final_epsilon)
+{
+	double			start_time = Wall_time();
+	Error			error = {0, ""};
+	priceType		epsilon;
+	priceType		last_epsilon;
+	//The number of dummy objects of the previous solve.
+	int				old_num_dummies = Instance->num_dummies;
+	
+	if (!Instance->is_solved)
+	{
+		Error_Set(&error, -1, "Error: The instance must be solved before it can be solved again in 'AS_Resolve_Instance'.");
+		return error;
+	}
+	if(initial_epsilon < 0 || final_epsilon < 0)
+	{
+		Error_Set(&error, -1, "Error: The initial and final values for epsilon can not be negative.");
+		return error;
+	}
+	//The memory of the previous solve must be kept.
+	if (Instance->maximum_cardinality && Instance->num_objects + Instance->num_persons > Instance->objects_capacity)
+	{
+		Error_Set(&error, -1, "Error: The maximum cardinality mode can not be turned on to solve again in 'AS_Resolve_Instance'.");
+		return error;
+	}
+	//If the graph has no perfect matching the prices and the matching are kept, to solve again after other changes.
+	Instance->Timings.presolve_time = 0;
+	error = AS_Prepare_solve(Instance);
+	Instance->Timings.prepare_time = Wall_time() - start_time;
+	if (error.code == -1)
+	{
+		strcat(error.msg, " In 'AS_Resolve_Instance'");
+		return error;
+	}
+	
+	//If the number of dummy objects changed, the persons of the removed ones are unmatched and the new ones are free.
+	for(int slot = Instance->num_objects + Instance->num_dummies; slot < Instance->num_objects + old_num_dummies; ++slot)
+		if (Instance->Matching[slot] != UNMATCHED) BD_Push_Back(&Instance->Unmatched_persons, Instance->Matching[slot]);
+	for(int slot = Instance->num_objects + old_num_dummies; slot < Instance->num_objects + Instance->num_dummies; ++slot)
+	{
+		Instance->Matching[slot] = UNMATCHED;
+		Instance->Matching_costs[slot] = 0;
+		Instance->Prices[slot] = 0;
+	}
+	
+	//The prices keep the scale of the previous solve.
+	epsilon = (priceType)(initial_epsilon * Instance->price_scale);
+#ifdef AS_INTEGER_COSTS
+	last_epsilon = (priceType)(final_epsilon * Instance->price_scale);
+	if(last_epsilon < 1) last_epsilon = 1;
+#else
+	if(final_epsilon == 0) final_epsilon = 1.0 / (Instance->num_persons + 2.0);
+	last_epsilon = final_epsilon;
+#endif
+	
+	//The persons unmatched by 'AS_Remove_edge' are already in the list of unmatched persons.
+	AS_Scaling_phases(Instance, epsilon, last_epsilon, alpha, 1);
+	NP_Restore_caller(&Instance->Placement);
+	
+	Instance->solving_time = Instance->Timings.phases_time + Instance->Timings.extraction_time;
+	Instance->is_solved = 1;
+	
+	Error_Set(&error, 1, "OK");
+	return error;
+}
+
+// An instance of the Assignment Problem for 'AS_Solve_batch', and its results.
+typedef struct
+{
+	// The graph, given by the arrays of its adjacency lists in CSR format (see 'Graph' in "types.h"). It is not modified.
+	int				num_persons;
+	int				num_objects;
+	const int		*offsets;
+	const int		*neighbors;
+	const costType	*costs;
+	// If not NULL, it must have 'num_objects' elements, and it gets the mate of each object.
+	int				*Matching;
+	// The cost of the matching, the solving time in seconds, and the result of 'AS_Solve_Instance'.
+	long int		matching_cost;
+	double			solving_time;
+	Error			error;
+} AS_Batch_instance;
+
+// Solve the 'num_instances' instances in 'Instances' one after the other on the same AuctionSolver instance, with its
+// options, the scaling factor 'alpha' and the final epsilon 'final_epsilon' (the initial epsilon of each instance is its
+// maximum absolute cost). Each graph is copied into the memory of the previous one, and the other arrays of the solver
+// only grow, so once the biggest instance has been solved no memory is allocated.
+// The results of each instance are in its members. If some instance was not solved, the error of the first one is returned.
+Error	AS_Solve_batch(AuctionSolver *Instance, AS_Batch_instance *Instances, int num_instances, double alpha, double final_epsilon)
+{
+	Error	error = {1, "OK"};
+	
+	for(int instance_i = 0; instance_i < num_instances; ++instance_i)
+	{
+		AS_Batch_instance	*Current = &Instances[instance_i];
+		
+		Current->error = AS_Set_graph(Instance, Current->num_persons, Current->num_objects, Current->offsets, Current->neighbors, Current->costs);
+		if (Current->error.code == 1)
+			Current->error = AS_Solve_Instance(Instance, (double)Instance->max_abs_cost, alpha, final_epsilon);
+		if (Current->error.code == -1)
+		{
+			Current->matching_cost = 0;
+			Current->solving_time = 0;
+			if (error.code == 1)
+			{
+				snprintf(error.msg, sizeof(error.msg), "%.150s In instance %d of 'AS_Solve_batch'", Current->error.msg, instance_i);
+				error.code = -1;
+			}
+			continue;
+		}
+		
+		Current->matching_cost = Instance->matching_cost;
+		Current->solving_time = Instance->solving_time;
+		if (Current->Matching != NULL)
+			memcpy(Current->Matching, Instance->Matching, Current->num_objects * sizeof(int));
+	}
+	
+	return error;
 }
 
 
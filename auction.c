@@ -2,6 +2,8 @@
 #include <string.h>
 #include "types.h"
 #include "AP_Tools.h"
+#include "batchsolver.h"
+#include "presolve.h"
 
 // Find the index of the last dot in 'file_path', and puts the file extension (whithout the dot) in 'extension'.
 // The last dot index is returned.
@@ -29,41 +31,206 @@ int	Get_file_extension(const char *file_path, char *extension)
 	return dot_index;
 }
 
+// Show how to use the program.
+void	Print_usage()
+{
+	printf("Usage: auction.exe [options] file_path\n");
+	printf("The file can be in binary format '.wbg', native binary format '.wbg2', text format '.txt' or a text matrix '.mat'\n");
+	printf("It can also be a directory of such files, or a container file '.wbgs' with several '.wbg' graphs one after\n");
+	printf("the other, to solve all of them at once (one instance per thread)\n");
+	printf("Options:\n");
+	printf("  -t num_threads    number of threads used to compute the bids, or to solve instances at once (default 1)\n");
+	printf("  -k kernel         fastest kernel for the scan of the adjacency lists: scalar, sse, avx2 or avx512 (default avx512)\n");
+	printf("  -w                keep the pairs that satisfy the epsilon-CS condition between scaling phases (warm start)\n");
+	printf("  -r num_pairs      use the combined forward/reverse auction, changing direction every num_pairs new pairs\n");
+	printf("  -a                adapt the reduction of epsilon to the bids of each scaling phase, and stop when optimal\n");
+	printf("  -b num_candidates keep the best num_candidates objects of each person between its bids (candidate cache)\n");
+	printf("  -q policy         order of the bids of the unmatched persons: lifo, fifo, evicted, price or degree (default lifo)\n");
+	printf("  -p                pack each neighbor and its cost in one word for the scan (only with integer costs)\n");
+	printf("  -m                find the cheapest of the maximum cardinality matchings, when there is no perfect matching\n");
+	printf("  -s                presolve: force the pairs of the vertices with one neighbor, solve the connected components\n");
+	printf("                    in parallel and subtract the minimum costs of the rows and the columns\n");
+	printf("  -o order          renumber the vertices of a sparse graph before solving, so that the neighbors of each person\n");
+	printf("                    have close indices: bfs or rcm (reverse Cuthill-McKee); the matching keeps the original indices\n");
+	printf("  -u                NUMA placement of the threads: pin them to the CPUs of the nodes, spread the graph over\n");
+	printf("                    the memory of their nodes and interleave the prices (only with more than one thread)\n");
+	printf("  -n                do not check that the graph has a perfect matching before solving\n");
+	printf("  -c output_path    convert the graph to the '.wbg2' format and save it in output_path, without solving\n");
+}
+
+// Solve all the instances of the directory or container file in 'path', with the options of 'Solver', and save
+// all the matchings to one file in the same place, terminating with '_matching.txt'.
+int		Solve_batch(AuctionSolver *Solver, char *path, int is_directory)
+{
+	BatchSolver		Batch;
+	Error			error;
+	char			output_path[520];
+	FILE			*output_file;
+	int				num_failed = 0;
+	int				path_len = strlen(path);
+	
+	BS_Defaults(&Batch);
+	Batch.num_threads = Solver->num_threads;
+	AS_Copy_options(&Batch.Options, Solver);
+	
+	if (is_directory) error = BS_Load_directory(&Batch, path);
+	else error = BS_Load_container(&Batch, path);
+	if (error.code == -1)
+	{
+		printf("\n%s\n", error.msg);
+		BS_Clear(&Batch);
+		return 1;
+	}
+	
+	BS_Solve(&Batch);
+	for(int instance_i = 0; instance_i < Batch.num_instances; ++instance_i)
+		num_failed += (Batch.Instances[instance_i].error.code == -1);
+	printf("\nInstances: %d (%d not solved)\nSolving time: %.5f sec\n", Batch.num_instances, num_failed, Batch.solving_time);
+	
+	// The output file is next to the directory or the container file.
+	while(path_len > 1 && path[path_len - 1] == '/') path[--path_len] = '\0';
+	if (!is_directory) *strrchr(path, '.') = '\0';
+	snprintf(output_path, sizeof(output_path), "%s_matching.txt", path);
+	output_file = fopen(output_path, "w");
+	if (output_file != NULL)
+	{
+		BS_Save_matchings_Text(&Batch, output_file);
+		fclose(output_file);
+	}
+	
+	BS_Clear(&Batch);
+	return (num_failed > 0 || output_file == NULL ? 1 : 0);
+}
+
 int		main(int argc, char *argv[])
 {
 	AuctionSolver	Solver;
+	Presolver		Presolve;
+	Error			error;
 	char			file_path[500];
 	char			file_extension[50];
+	// The path of the '.wbg2' file when converting the graph, or NULL.
+	char			*convert_path = NULL;
+	struct stat		file_stat;
 	int				dot_index = 0;
+	int				presolve = 0;
+	// The 'AS_ORDER_*' value to reorder the graph, or '0'.
+	int				order = 0;
 	
 	
 	// Make sure a file path of an Assignment Problem instance was sent.
 	if (argc < 2)
 	{
-		printf("Usage: auction.exe file_path\n");
-		printf("The file can be in binary format '.wbg' or text format '.txt'\n");
+		Print_usage();
 		return 0;
 	}
 	
 	// This function always needs to be called on an 'AuctionSolver' to initialize to safe values.
 	AS_Defaults(&Solver);
 	
+	// Read the options, the file path is the last argument.
+	for (int arg_i = 1; arg_i < argc - 1; ++arg_i)
+	{
+		if (strcmp(argv[arg_i], "-t") == 0 && arg_i + 1 < argc - 1) Solver.num_threads = atoi(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-k") == 0 && arg_i + 1 < argc - 1 && RC_Kernel_from_name(argv[arg_i + 1]) != -1)
+			Solver.max_kernel = RC_Kernel_from_name(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-w") == 0) Solver.warm_start = 1;
+		else if (strcmp(argv[arg_i], "-r") == 0 && arg_i + 1 < argc - 1) Solver.reverse_switch = atoi(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-a") == 0) Solver.adaptive_epsilon = 1;
+		else if (strcmp(argv[arg_i], "-b") == 0 && arg_i + 1 < argc - 1) Solver.candidate_cache = atoi(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-q") == 0 && arg_i + 1 < argc - 1 && AS_Queue_policy_from_name(argv[arg_i + 1]) != -1)
+			Solver.queue_policy = AS_Queue_policy_from_name(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-p") == 0) Solver.packed_edges = 1;
+		else if (strcmp(argv[arg_i], "-m") == 0) Solver.maximum_cardinality = 1;
+		else if (strcmp(argv[arg_i], "-s") == 0) presolve = 1;
+		else if (strcmp(argv[arg_i], "-o") == 0 && arg_i + 1 < argc - 1 && AS_Order_from_name(argv[arg_i + 1]) != -1)
+			order = AS_Order_from_name(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-u") == 0) Solver.numa_placement = 1;
+		else if (strcmp(argv[arg_i], "-n") == 0) Solver.check_feasibility = 0;
+		else if (strcmp(argv[arg_i], "-c") == 0 && arg_i + 1 < argc - 1) convert_path = argv[++arg_i];
+		else
+		{
+			Print_usage();
+			return 0;
+		}
+	}
+	
 	// Load a graph from the file, depending on the file extension.
-	strcpy(file_path, argv[1]);
+	strcpy(file_path, argv[argc - 1]);
 	dot_index = Get_file_extension(file_path, file_extension);
-	if (strcmp(file_extension, "txt") == 0) AS_Load_graph_Text(&Solver, file_path);
-	else AS_Load_graph_Binary(&Solver, file_path);
+	
+	// Solve many instances at once.
+	if (stat(file_path, &file_stat) == 0 && S_ISDIR(file_stat.st_mode)) return Solve_batch(&Solver, file_path, 1);
+	if (strcmp(file_extension, "wbgs") == 0) return Solve_batch(&Solver, file_path, 0);
+	
+	if (strcmp(file_extension, "txt") == 0) error = AS_Load_graph_Text(&Solver, file_path);
+	else if (strcmp(file_extension, "wbg2") == 0) error = AS_Load_graph_Wbg2(&Solver, file_path);
+	else if (strcmp(file_extension, "mat") == 0) error = AS_Load_matrix_Text(&Solver, file_path);
+	else error = AS_Load_graph_Binary(&Solver, file_path);
+	if (error.code == -1)
+	{
+		printf("\n%s\n", error.msg);
+		AS_Clear(&Solver);
+		return 1;
+	}
+	
+	// Only convert the graph.
+	if (convert_path != NULL)
+	{
+		error = AS_Save_graph_Wbg2(&Solver, convert_path);
+		if (error.code == -1) printf("\n%s\n", error.msg);
+		AS_Clear(&Solver);
+		return (error.code == -1 ? 1 : 0);
+	}
+	
+	// Renumber the vertices for the locality of the scans.
+	if (order != 0)
+	{
+		error = AS_Reorder_graph(&Solver, order);
+		if (error.code == -1)
+		{
+			printf("\n%s\n", error.msg);
+			AS_Clear(&Solver);
+			return 1;
+		}
+	}
 	
 	// Solve the intance.
-	AS_Solve_Instance(&Solver, (double)Solver.max_abs_cost, 7.0, 0);
+	PS_Defaults(&Presolve);
+	if (presolve) error = PS_Solve(&Presolve, &Solver, 7.0);
+	else error = AS_Solve_Instance(&Solver, (double)Solver.max_abs_cost, 7.0, 0);
+	if (error.code == -1)
+	{
+		printf("\n%s\n", error.msg);
+		PS_Clear(&Presolve);
+		AS_Clear(&Solver);
+		return 1;
+	}
 	
 	// Show the matching cost and the solving time.
 	printf("\nMatching cost: %u\nSolving time: %.5f sec\n", Solver.matching_cost, Solver.solving_time);
+	if (presolve) printf("Forced pairs: %d\nComponents: %d\nPresolve time: %.5f sec\n", Presolve.num_forced,
+		Presolve.num_components, Presolve.presolve_time);
+	else printf("Scaling phases: %d\nBids: %ld\n", Solver.num_phases, Solver.num_bids);
+	if (Solver.numa_placement && Solver.Placement.num_threads > 1)
+		printf("NUMA nodes: %d\nPinned threads: %d of %d\nInterleaved: %ld KB\n", Solver.Placement.num_nodes,
+			Solver.Placement.num_pinned, Solver.Placement.num_threads, Solver.Placement.interleaved_bytes / 1024);
+	PS_Clear(&Presolve);
 	
 	// Save the matching to a file in the same place as the input file, but terminating with '_matching.txt'.
 	file_path[dot_index] = '\0';
 	strcat(file_path, "_matching.txt");
 	AS_Save_matching_Text(&Solver, file_path);
+	printf("Load time: %.6f sec\nPrepare time: %.6f sec\nPhases time: %.6f sec\nExtraction time: %.6f sec\nOutput time: %.6f sec\n",
+		Solver.Timings.load_time, Solver.Timings.prepare_time, Solver.Timings.phases_time, Solver.Timings.extraction_time,
+		Solver.Timings.output_time);
+#ifdef AS_STATS
+	// Save the statistics of the phases in the same place, terminating with '_stats.json'.
+	file_path[dot_index] = '\0';
+	strcat(file_path, "_stats.json");
+	error = AS_Save_stats_Json(&Solver, file_path);
+	if (error.code == -1) printf("\n%s\n", error.msg);
+#endif
 	
 	//AS_Display_Instance(&Solver);
 	
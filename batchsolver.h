@@ -0,0 +1,377 @@
+#ifndef _T_BATCH_SOLVER_
+#define _T_BATCH_SOLVER_
+
+#include <stdio.h>
+#include <dirent.h>
+#include "error.h"
+#include "types.h"
+#include "threadpool.h"
+#include "AP_Tools.h"
+
+//*****************************************************************************************
+// BATCHSOLVER STRUCTURE
+/*
+	Structure that solves many independent instances of the Assignment Problem at once, which pays off
+	when the instances are small: they are loaded from a directory or from a container file, solved
+	concurrently by the threads of a pool, each thread with its own 'AuctionSolver', and all the matchings
+	are written to one output file.
+	The threads take the instances from a shared counter, from the biggest to the smallest one, so that
+	a big instance is started first and the small ones fill the gaps of the other threads, instead of
+	splitting the instances in fixed shares.
+*/
+
+// An instance of the batch: its graph and its results.
+typedef struct
+{
+	// The name of the instance: the file name, or the position in the container file.
+	char		name[256];
+	// The graph of the instance.
+	int			num_objects;
+	int			max_abs_cost;
+	Graph		Persons;
+	// The results: the mate and the cost of the edge of each object, the matching cost, the solving time
+	// and the result of 'AS_Solve_Instance'.
+	int			*Matching;
+	costType	*Matching_costs;
+	long int	matching_cost;
+	double		solving_time;
+	Error		error;
+} BS_Instance;
+
+typedef struct
+{
+	// The instances, and the number of them that fit in the array.
+	int				num_instances;
+	int				max_instances;
+	BS_Instance		*Instances;
+	// The order in which the instances are solved, and the position in it of the next one to solve.
+	int				*Order;
+	int				next_instance;
+	// The threads, and the solver of each thread and the number of them.
+	ThreadPool		Workers;
+	AuctionSolver	*Solvers;
+	int				num_solvers;
+	// The time in seconds spent solving all the instances.
+	double			solving_time;
+	
+// OPTIONS OF THE BATCH. They can be changed after 'BS_Defaults' and before 'BS_Solve'.
+	// The number of threads that solve instances at once.
+	int				num_threads;
+	// The scaling factor of epsilon (see 'AS_Solve_Instance'). The initial epsilon of each instance is its maximum
+	// absolute cost, and the final one is optimal.
+	double			alpha;
+	// The options of the solvers of the threads (see 'AuctionSolver'). Each instance is solved by one thread,
+	// so 'Options.num_threads' is only used when there is a single instance, which is solved by the parallel auction.
+	AuctionSolver	Options;
+} BatchSolver;
+
+//***********************************
+// BATCHSOLVER METHODS
+
+// Constructor: initializes the members to safe default values.
+// This function always needs to be called on a 'BatchSolver' instance before any other move.
+void	BS_Defaults(BatchSolver *Batch)
+{
+	Batch->num_instances = 0;
+	Batch->max_instances = 0;
+	Batch->Instances = NULL;
+	Batch->Order = NULL;
+	Batch->next_instance = 0;
+	TP_Defaults(&Batch->Workers);
+	Batch->Solvers = NULL;
+	Batch->num_solvers = 0;
+	Batch->solving_time = 0;
+	Batch->num_threads = 1;
+	Batch->alpha = 7.0;
+	AS_Defaults(&Batch->Options);
+}
+
+// Safe destructor: free the memory and set everything to default values.
+void	BS_Clear(BatchSolver *Batch)
+{
+	for(int instance_i = 0; instance_i < Batch->num_instances; ++instance_i)
+	{
+		Graph_Clear(&Batch->Instances[instance_i].Persons);
+		free((char*) Batch->Instances[instance_i].Matching);
+		free((char*) Batch->Instances[instance_i].Matching_costs);
+	}
+	free((char*) Batch->Instances);
+	free((char*) Batch->Order);
+	for(int thread_i = 0; thread_i < Batch->num_solvers; ++thread_i) AS_Clear(&Batch->Solvers[thread_i]);
+	free((char*) Batch->Solvers);
+	TP_Clear(&Batch->Workers);
+	AS_Clear(&Batch->Options);
+	BS_Defaults(Batch);
+}
+
+// Add an instance with the name 'name' and the graph loaded on 'Loader', which keeps no graph afterwards.
+// In case of error, an Error instance will be returned.
+Error	BS_Add_instance(BatchSolver *Batch, const char *name, AuctionSolver *Loader)
+{
+	Error			error = {1, "OK"};
+	BS_Instance		*Instances;
+	BS_Instance		*Added;
+	
+	// Make room for the instance, doubling the array.
+	if (Batch->num_instances == Batch->max_instances)
+	{
+		Instances = (BS_Instance*) realloc(Batch->Instances, (2 * Batch->max_instances + 16) * sizeof(BS_Instance));
+		if (Instances == NULL)
+		{
+			Error_Set(&error, -1, "Error: no memory for the allocation of the instances in 'BS_Add_instance'");
+			return error;
+		}
+		Batch->Instances = Instances;
+		Batch->max_instances = 2 * Batch->max_instances + 16;
+	}
+	
+	// Take the graph of the loader.
+	Added = &Batch->Instances[Batch->num_instances++];
+	snprintf(Added->name, sizeof(Added->name), "%s", name);
+	Added->num_objects = Loader->num_objects;
+	Added->max_abs_cost = Loader->max_abs_cost;
+	Added->Persons = Loader->Persons;
+	Graph_Defaults(&Loader->Persons);
+	Loader->num_persons = 0;
+	Loader->num_objects = 0;
+	Loader->max_abs_cost = 0;
+	Added->Matching = NULL;
+	Added->Matching_costs = NULL;
+	Added->matching_cost = 0;
+	Added->solving_time = 0;
+	Error_Set(&Added->error, -1, "Error: the instance was not solved");
+	
+	return error;
+}
+
+// Load all the graph files ('.txt', '.wbg', '.wbg2' and '.mat') of the directory in 'directory_path' as instances,
+// in the order of their names.
+// In case of error, an Error instance will be returned.
+Error	BS_Load_directory(BatchSolver *Batch, const char *directory_path)
+{
+	Error			error = {1, "OK"};
+	AuctionSolver	Loader;
+	struct dirent	**entries = NULL;
+	int				num_entries = 0;
+	char			file_path[1024];
+	const char		*extension;
+	
+	num_entries = scandir(directory_path, &entries, NULL, alphasort);
+	if (num_entries < 0)
+	{
+		Error_Set(&error, -1, "Error: the directory does not exist, in 'BS_Load_directory'");
+		return error;
+	}
+	
+	AS_Defaults(&Loader);
+	for(int entry_i = 0; entry_i < num_entries; ++entry_i)
+	{
+		extension = strrchr(entries[entry_i]->d_name, '.');
+		snprintf(file_path, sizeof(file_path), "%s/%s", directory_path, entries[entry_i]->d_name);
+		if (error.code == -1 || extension == NULL) continue;
+		if (strcmp(extension, ".txt") == 0) error = AS_Load_graph_Text(&Loader, file_path);
+		else if (strcmp(extension, ".wbg") == 0) error = AS_Load_graph_Binary(&Loader, file_path);
+		else if (strcmp(extension, ".wbg2") == 0) error = AS_Load_graph_Wbg2(&Loader, file_path);
+		else if (strcmp(extension, ".mat") == 0) error = AS_Load_matrix_Text(&Loader, file_path);
+		else continue;
+		if (error.code == 1) error = BS_Add_instance(Batch, entries[entry_i]->d_name, &Loader);
+		if (error.code == -1)
+		{
+			snprintf(file_path, sizeof(file_path), " In the file '%s' in 'BS_Load_directory'", entries[entry_i]->d_name);
+			strncat(error.msg, file_path, sizeof(error.msg) - strlen(error.msg) - 1);
+		}
+	}
+	
+	for(int entry_i = 0; entry_i < num_entries; ++entry_i) free(entries[entry_i]);
+	free(entries);
+	AS_Clear(&Loader);
+	return error;
+}
+
+// Load all the graphs of the container file in 'file_path' as instances. A container file ('.wbgs') is just
+// several graphs in binary format (see 'AS_Load_graph_Binary') one after the other. The instances are named
+// by their position in the file.
+// In case of error, an Error instance will be returned.
+Error	BS_Load_container(BatchSolver *Batch, const char *file_path)
+{
+	Error			error = {1, "OK"};
+	AuctionSolver	Loader;
+	int				*file_data = NULL;
+	long int		file_size = 0;
+	long int		position = 0;
+	char			name[256];
+	
+	file_data = (int*) Map_file(file_path, &file_size);
+	if (file_data == NULL)
+	{
+		Error_Set(&error, -1, "Error: the container file does not exist or is empty, in 'BS_Load_container'");
+		return error;
+	}
+	madvise(file_data, file_size, MADV_SEQUENTIAL);
+	
+	AS_Defaults(&Loader);
+	while(error.code == 1 && position < file_size / (long int)sizeof(int))
+	{
+		error = AS_Read_graph_Binary(&Loader, file_data, file_size / sizeof(int), &position);
+		snprintf(name, sizeof(name), "%d", Batch->num_instances);
+		if (error.code == 1) error = BS_Add_instance(Batch, name, &Loader);
+		if (error.code == -1)
+		{
+			snprintf(name, sizeof(name), " In the graph %d in 'BS_Load_container'", Batch->num_instances);
+			strncat(error.msg, name, sizeof(error.msg) - strlen(error.msg) - 1);
+		}
+	}
+	
+	munmap(file_data, file_size);
+	AS_Clear(&Loader);
+	return error;
+}
+
+// Task run by each thread of the pool: take the next instance to solve until there are no more, solving them
+// with the solver of the thread. The graph of the instance is lent to the solver, and the matching is moved to the instance.
+void	BS_Solve_task(void *arg, int thread_i, int num_threads)
+{
+	BatchSolver		*Batch = (BatchSolver*) arg;
+	AuctionSolver	*Solver = &Batch->Solvers[thread_i];
+	BS_Instance		*Current;
+	int				order_i = 0;
+	
+	(void)num_threads;
+	while(1)
+	{
+		order_i = __atomic_fetch_add(&Batch->next_instance, 1, __ATOMIC_RELAXED);
+		if (order_i >= Batch->num_instances) break;
+		Current = &Batch->Instances[Batch->Order[order_i]];
+		
+		Solver->Persons = Current->Persons;
+		Solver->num_persons = Current->Persons.num_persons;
+		Solver->num_objects = Current->num_objects;
+		Solver->max_abs_cost = Current->max_abs_cost;
+		Current->error = AS_Solve_Instance(Solver, (double)Current->max_abs_cost, Batch->alpha, 0);
+		// The graph is taken back as the solver left it, since it may have moved it (see 'AS_Place_memory'). After an
+		// allocation error the solver is cleared, and so is the graph.
+		Current->Persons = Solver->Persons;
+		Graph_Defaults(&Solver->Persons);
+		if (Current->error.code == -1) continue;
+		
+		Current->matching_cost = Solver->matching_cost;
+		Current->solving_time = Solver->solving_time;
+		Current->Matching = Solver->Matching;
+		Current->Matching_costs = Solver->Matching_costs;
+		Solver->Matching = NULL;
+		Solver->Matching_costs = NULL;
+	}
+}
+
+// The size of an instance, to sort the instances.
+typedef struct
+{
+	int		num_edges;
+	int		instance_i;
+} BS_Size;
+
+// Compare two instances by their number of edges, from the biggest to the smallest ('qsort' function).
+int		BS_Compare_sizes(const void *first, const void *second)
+{
+	const BS_Size	*first_size = (const BS_Size*) first;
+	const BS_Size	*second_size = (const BS_Size*) second;
+	
+	if (first_size->num_edges != second_size->num_edges) return (first_size->num_edges > second_size->num_edges ? -1 : 1);
+	return first_size->instance_i - second_size->instance_i;
+}
+
+// Solve all the instances with 'num_threads' threads, with the options in 'Options' and the scaling factor 'alpha'.
+// The results of each instance are in its members. If some instance was not solved, the error of the first one is returned.
+Error	BS_Solve(BatchSolver *Batch)
+{
+	Error		error = {1, "OK"};
+	double		start_time;
+	BS_Size		*sizes = NULL;
+	
+	// Start the threads and their solvers. A single instance is solved by the parallel auction instead.
+	error = TP_Create(&Batch->Workers, (Batch->num_instances == 1 ? 1 : Batch->num_threads));
+	if (error.code == -1)
+	{
+		strcat(error.msg, " In 'BS_Solve'");
+		return error;
+	}
+	// The solvers and the results of the previous solve are freed, there may be a different number of them now.
+	for(int thread_i = 0; thread_i < Batch->num_solvers; ++thread_i) AS_Clear(&Batch->Solvers[thread_i]);
+	free((char*) Batch->Solvers);
+	Batch->num_solvers = 0;
+	for(int instance_i = 0; instance_i < Batch->num_instances; ++instance_i)
+	{
+		free((char*) Batch->Instances[instance_i].Matching);
+		free((char*) Batch->Instances[instance_i].Matching_costs);
+		Batch->Instances[instance_i].Matching = NULL;
+		Batch->Instances[instance_i].Matching_costs = NULL;
+	}
+	Batch->Solvers = (AuctionSolver*) malloc(Batch->Workers.num_threads * sizeof(AuctionSolver));
+	Batch->Order = (int*) realloc(Batch->Order, (Batch->num_instances + 1) * sizeof(int));
+	sizes = (BS_Size*) malloc((Batch->num_instances + 1) * sizeof(BS_Size));
+	if (Batch->Solvers == NULL || Batch->Order == NULL || sizes == NULL)
+	{
+		free((char*) sizes);
+		Error_Set(&error, -1, "Error: no memory for the allocation of the solvers in 'BS_Solve'");
+		return error;
+	}
+	Batch->num_solvers = Batch->Workers.num_threads;
+	for(int thread_i = 0; thread_i < Batch->num_solvers; ++thread_i)
+	{
+		AS_Defaults(&Batch->Solvers[thread_i]);
+		AS_Copy_options(&Batch->Solvers[thread_i], &Batch->Options);
+		Batch->Solvers[thread_i].num_threads = (Batch->num_instances == 1 ? Batch->num_threads : 1);
+	}
+	
+	// Solve the biggest instances first.
+	for(int instance_i = 0; instance_i < Batch->num_instances; ++instance_i)
+	{
+		sizes[instance_i].num_edges = Batch->Instances[instance_i].Persons.num_edges;
+		sizes[instance_i].instance_i = instance_i;
+	}
+	qsort(sizes, Batch->num_instances, sizeof(BS_Size), BS_Compare_sizes);
+	for(int instance_i = 0; instance_i < Batch->num_instances; ++instance_i) Batch->Order[instance_i] = sizes[instance_i].instance_i;
+	free((char*) sizes);
+	Batch->next_instance = 0;
+	
+	start_time = Wall_time();
+	TP_Run(&Batch->Workers, BS_Solve_task, Batch);
+	Batch->solving_time = Wall_time() - start_time;
+	
+	for(int instance_i = 0; instance_i < Batch->num_instances && error.code == 1; ++instance_i)
+		if (Batch->Instances[instance_i].error.code == -1)
+		{
+			snprintf(error.msg, sizeof(error.msg), "%.120s In the instance '%.40s' in 'BS_Solve'",
+				Batch->Instances[instance_i].error.msg, Batch->Instances[instance_i].name);
+			error.code = -1;
+		}
+	
+	return error;
+}
+
+// Write the results of all the instances to 'output_file', one after the other in the order they were loaded.
+// Each one begins with the lines "instance name" and "cost matching_cost" followed by its matching, one edge per
+// line as "person_index,object_index,cost" without the unmatched objects (see 'AS_Save_matching_Text'), or with the lines "instance name" and
+// "error message" if it was not solved.
+void	BS_Save_matchings_Text(BatchSolver *Batch, FILE *output_file)
+{
+	BS_Instance		*Current;
+	
+	for(int instance_i = 0; instance_i < Batch->num_instances; ++instance_i)
+	{
+		Current = &Batch->Instances[instance_i];
+		fprintf(output_file, "instance %s\n", Current->name);
+		if (Current->error.code == -1)
+		{
+			fprintf(output_file, "error %s\n", Current->error.msg);
+			continue;
+		}
+		fprintf(output_file, "cost %.0f\n", (double)Current->matching_cost);
+		for (int object_i = 0; object_i < Current->num_objects; ++object_i)
+			if (Current->Matching[object_i] != UNMATCHED) fprintf(output_file, "%d,%d,%.0lf\n", Current->Matching[object_i], object_i, (double)Current->Matching_costs[object_i]);
+	}
+}
+
+//*****************************************************************************************
+
+#endif
@@ -0,0 +1,292 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include "types.h"
+#include "AP_Tools.h"
+#include "generators.h"
+
+// Maximum number of results of a run or of a baseline file.
+#define BM_MAX_RESULTS	256
+// Maximum number of solves of each instance.
+#define BM_MAX_REPETITIONS	100
+
+// The result of the benchmark of one instance.
+typedef struct
+{
+	// The instance: its family, size, average degree, maximum cost and seed (see "generators.h").
+	char		family[20];
+	int			n;
+	int			degree;
+	int			max_cost;
+	int			seed;
+	// The queue policy of the solver (see 'AS_Queue_policy_name').
+	char		policy[20];
+	// The cost of the matching, the median wall-clock time of the solves in seconds, the bids per second of
+	// the median solve, the peak memory of the process in kilobytes after the solves, and the bids of the last solve.
+	double		matching_cost;
+	double		median_time;
+	double		bids_per_second;
+	long int	max_rss;
+	long int	bids;
+} BM_Result;
+
+// Show how to use the program.
+void	Print_usage()
+{
+	printf("Usage: benchmark.exe [options]\n");
+	printf("Generates instances of the families in \"generators.h\", solves each one several times and shows the median\n");
+	printf("wall-clock time, the bids per second and the peak memory\n");
+	printf("Options:\n");
+	printf("  -f family         dense, sparse, geometric, hard or all (default all)\n");
+	printf("  -n size           number of persons and objects (default 1000)\n");
+	printf("  -d degree         average degree, or number of cheap objects of the hard family (default 10)\n");
+	printf("  -m max_cost       maximum edge cost (default 1000)\n");
+	printf("  -s seed           random seed, the instances are generated with seeds seed, seed+1, ... (default 1)\n");
+	printf("  -g num_seeds      number of instances of each family (default 1)\n");
+	printf("  -i repetitions    number of solves of each instance (default 5)\n");
+	printf("  -o output_path    save the results, to be used as a baseline\n");
+	printf("  -b baseline_path  compare the results with a baseline saved with '-o'\n");
+	printf("  -x tolerance      percentage of time above the baseline reported as a regression (default 10)\n");
+	printf("  -q policy         queue policy of the solver as in auction.exe, or all to compare them (default lifo)\n");
+	printf("  -t, -k, -w, -r, -a, -p, -u: solver options, as in auction.exe\n");
+}
+
+// Compare two doubles, for 'qsort'.
+int		BM_Compare_doubles(const void *a, const void *b)
+{
+	double	x = *(const double*) a;
+	double	y = *(const double*) b;
+	return (x > y) - (x < y);
+}
+
+// Generate the instance of 'Result' and solve it 'repetitions' times with 'Solver', filling the rest of 'Result'.
+// In case of error, an Error instance will be returned.
+Error	BM_Run_instance(AuctionSolver *Solver, BM_Result *Result, int repetitions)
+{
+	Error		error;
+	Graph		G;
+	// The times of the solves, at most 'BM_MAX_REPETITIONS'.
+	double		times[BM_MAX_REPETITIONS];
+	double		start_time = 0;
+	long int	bids = 0;
+	struct rusage	usage;
+	
+	Graph_Defaults(&G);
+	error = GEN_Generate(&G, GEN_Family_from_name(Result->family), Result->n, Result->degree, Result->max_cost,
+		(unsigned long long)Result->seed);
+	if (error.code == 1) error = AS_Set_graph(Solver, G.num_persons, Result->n, G.offsets, G.neighbors, G.costs);
+	Graph_Clear(&G);
+	if (error.code == -1)
+	{
+		strcat(error.msg, " In 'BM_Run_instance'");
+		return error;
+	}
+	
+	if (repetitions > BM_MAX_REPETITIONS) repetitions = BM_MAX_REPETITIONS;
+	for (int repetition_i = 0; repetition_i < repetitions; ++repetition_i)
+	{
+		bids = Solver->num_bids;
+		start_time = Wall_time();
+		error = AS_Solve_Instance(Solver, (double)Solver->max_abs_cost, 7.0, 0);
+		times[repetition_i] = Wall_time() - start_time;
+		bids = Solver->num_bids - bids;
+		if (error.code == -1)
+		{
+			strcat(error.msg, " In 'BM_Run_instance'");
+			return error;
+		}
+	}
+	qsort(times, repetitions, sizeof(double), BM_Compare_doubles);
+	Result->median_time = times[repetitions / 2];
+	// All the solves do the same bids, except with threads.
+	Result->bids_per_second = (Result->median_time > 0 ? bids / Result->median_time : 0);
+	Result->bids = bids;
+	Result->matching_cost = (double)Solver->matching_cost;
+	getrusage(RUSAGE_SELF, &usage);
+	Result->max_rss = usage.ru_maxrss;
+	
+	return error;
+}
+
+// Write a result as a line of a results file, which is also the format of the baselines.
+// The policy and the bids are the last fields, since the first baselines did not have them.
+void	BM_Write_result(FILE *output_file, const BM_Result *Result)
+{
+	fprintf(output_file, "%s %d %d %d %d %.0f %.6f %.0f %ld %s %ld\n", Result->family, Result->n, Result->degree,
+		Result->max_cost, Result->seed, Result->matching_cost, Result->median_time, Result->bids_per_second, Result->max_rss,
+		Result->policy, Result->bids);
+}
+
+// Read the results of a baseline file into 'Results', and return their number, or '-1' if the file can not be read.
+// The lines that begin with '#' are ignored, and the results without policy are taken as 'lifo' results.
+int		BM_Read_baseline(const char *file_path, BM_Result *Results)
+{
+	FILE	*input_file;
+	char	line[500];
+	int		num_results = 0;
+	
+	input_file = fopen(file_path, "r");
+	if (input_file == NULL) return -1;
+	while (num_results < BM_MAX_RESULTS && fgets(line, sizeof(line), input_file) != NULL)
+	{
+		if (line[0] == '#') continue;
+		strcpy(Results[num_results].policy, AS_Queue_policy_name(AS_QUEUE_LIFO));
+		Results[num_results].bids = 0;
+		if (sscanf(line, "%19s %d %d %d %d %lf %lf %lf %ld %19s %ld", Results[num_results].family, &Results[num_results].n,
+			&Results[num_results].degree, &Results[num_results].max_cost, &Results[num_results].seed,
+			&Results[num_results].matching_cost, &Results[num_results].median_time,
+			&Results[num_results].bids_per_second, &Results[num_results].max_rss, Results[num_results].policy,
+			&Results[num_results].bids) >= 9) ++num_results;
+	}
+	fclose(input_file);
+	return num_results;
+}
+
+int		main(int argc, char *argv[])
+{
+	AuctionSolver	Solver;
+	Error			error = {1, "OK"};
+	BM_Result		Results[BM_MAX_RESULTS];
+	BM_Result		Baseline[BM_MAX_RESULTS];
+	BM_Result		*Result;
+	BM_Result		*Base;
+	FILE			*output_file;
+	char			*output_path = NULL;
+	char			*baseline_path = NULL;
+	char			*family_name = "all";
+	char			*policy_name = "lifo";
+	int				n = 1000;
+	int				degree = 10;
+	int				max_cost = 1000;
+	int				seed = 1;
+	int				num_seeds = 1;
+	int				repetitions = 5;
+	double			tolerance = 10;
+	int				num_results = 0;
+	int				num_baseline = 0;
+	int				num_regressions = 0;
+	
+	// This function always needs to be called on an 'AuctionSolver' to initialize to safe values.
+	AS_Defaults(&Solver);
+	
+	// Read the options.
+	for (int arg_i = 1; arg_i < argc; ++arg_i)
+	{
+		if (strcmp(argv[arg_i], "-f") == 0 && arg_i + 1 < argc
+			&& (strcmp(argv[arg_i + 1], "all") == 0 || GEN_Family_from_name(argv[arg_i + 1]) != -1)) family_name = argv[++arg_i];
+		else if (strcmp(argv[arg_i], "-n") == 0 && arg_i + 1 < argc) n = atoi(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-d") == 0 && arg_i + 1 < argc) degree = atoi(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-m") == 0 && arg_i + 1 < argc) max_cost = atoi(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-s") == 0 && arg_i + 1 < argc) seed = atoi(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-g") == 0 && arg_i + 1 < argc) num_seeds = atoi(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-i") == 0 && arg_i + 1 < argc) repetitions = atoi(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-o") == 0 && arg_i + 1 < argc) output_path = argv[++arg_i];
+		else if (strcmp(argv[arg_i], "-b") == 0 && arg_i + 1 < argc) baseline_path = argv[++arg_i];
+		else if (strcmp(argv[arg_i], "-x") == 0 && arg_i + 1 < argc) tolerance = atof(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-t") == 0 && arg_i + 1 < argc) Solver.num_threads = atoi(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-k") == 0 && arg_i + 1 < argc && RC_Kernel_from_name(argv[arg_i + 1]) != -1)
+			Solver.max_kernel = RC_Kernel_from_name(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-w") == 0) Solver.warm_start = 1;
+		else if (strcmp(argv[arg_i], "-r") == 0 && arg_i + 1 < argc) Solver.reverse_switch = atoi(argv[++arg_i]);
+		else if (strcmp(argv[arg_i], "-a") == 0) Solver.adaptive_epsilon = 1;
+		else if (strcmp(argv[arg_i], "-p") == 0) Solver.packed_edges = 1;
+		else if (strcmp(argv[arg_i], "-u") == 0) Solver.numa_placement = 1;
+		else if (strcmp(argv[arg_i], "-q") == 0 && arg_i + 1 < argc
+			&& (strcmp(argv[arg_i + 1], "all") == 0 || AS_Queue_policy_from_name(argv[arg_i + 1]) != -1)) policy_name = argv[++arg_i];
+		else
+		{
+			Print_usage();
+			return 0;
+		}
+	}
+	if (n <= 0 || degree <= 0 || max_cost < 0 || num_seeds <= 0 || repetitions <= 0)
+	{
+		Print_usage();
+		return 0;
+	}
+	
+	// Read the baseline.
+	if (baseline_path != NULL)
+	{
+		num_baseline = BM_Read_baseline(baseline_path, Baseline);
+		if (num_baseline == -1)
+		{
+			printf("\nError: the baseline '%s' can not be read\n", baseline_path);
+			return 1;
+		}
+	}
+	
+	// Solve the instances, with each policy if all of them are compared.
+	printf("%-10s %8s %6s %10s %6s %8s %16s %12s %12s %14s %12s", "family", "n", "degree", "max_cost", "seed", "policy", "cost",
+		"median_time", "bids", "bids/s", "max_rss_kb");
+	printf(baseline_path != NULL ? " %9s\n" : "\n", "speedup");
+	for (int family = 0; family < GEN_NUM_FAMILIES && error.code == 1; ++family)
+	{
+		if (strcmp(family_name, "all") != 0 && GEN_Family_from_name(family_name) != family) continue;
+		for (int seed_i = 0; seed_i < num_seeds && error.code == 1; ++seed_i)
+		{
+			for (int policy = AS_QUEUE_LIFO; policy <= AS_QUEUE_DEGREE && num_results < BM_MAX_RESULTS; ++policy)
+			{
+				if (strcmp(policy_name, "all") != 0 && AS_Queue_policy_from_name(policy_name) != policy) continue;
+				Solver.queue_policy = policy;
+				Result = &Results[num_results];
+				strcpy(Result->family, GEN_FAMILY_NAMES[family]);
+				Result->n = n;
+				Result->degree = degree;
+				Result->max_cost = max_cost;
+				Result->seed = seed + seed_i;
+				strcpy(Result->policy, AS_Queue_policy_name(policy));
+				error = BM_Run_instance(&Solver, Result, repetitions);
+				if (error.code == -1) break;
+				++num_results;
+				printf("%-10s %8d %6d %10d %6d %8s %16.0f %12.6f %12ld %14.0f %12ld", Result->family, Result->n, Result->degree,
+					Result->max_cost, Result->seed, Result->policy, Result->matching_cost, Result->median_time, Result->bids,
+					Result->bids_per_second, Result->max_rss);
+				
+				// Compare with the same instance and policy of the baseline: a different cost is always an error.
+				Base = NULL;
+				for (int base_i = 0; base_i < num_baseline; ++base_i)
+					if (strcmp(Baseline[base_i].family, Result->family) == 0 && Baseline[base_i].n == Result->n
+						&& Baseline[base_i].degree == Result->degree && Baseline[base_i].max_cost == Result->max_cost
+						&& Baseline[base_i].seed == Result->seed && strcmp(Baseline[base_i].policy, Result->policy) == 0)
+						Base = &Baseline[base_i];
+				if (Base != NULL)
+				{
+					printf(" %9.3f", Result->median_time > 0 ? Base->median_time / Result->median_time : 0);
+					if (Base->matching_cost != Result->matching_cost)
+					{
+						printf("  WRONG COST (baseline %.0f)", Base->matching_cost);
+						++num_regressions;
+					}
+					else if (Result->median_time > Base->median_time * (1 + tolerance / 100))
+					{
+						printf("  SLOWER");
+						++num_regressions;
+					}
+				}
+				else if (baseline_path != NULL) printf(" %9s", "-");
+				printf("\n");
+			}
+		}
+	}
+	if (error.code == -1) printf("\n%s\n", error.msg);
+	if (baseline_path != NULL) printf("\nRegressions against the baseline: %d\n", num_regressions);
+	
+	// Save the results.
+	if (output_path != NULL)
+	{
+		output_file = fopen(output_path, "w");
+		if (output_file == NULL) printf("\nError: the results can not be saved in '%s'\n", output_path);
+		else
+		{
+			fprintf(output_file, "# family n degree max_cost seed cost median_time bids_per_second max_rss_kb policy bids\n");
+			for (int result_i = 0; result_i < num_results; ++result_i) BM_Write_result(output_file, &Results[result_i]);
+			fclose(output_file);
+		}
+	}
+	
+	// Free the memory.
+	AS_Clear(&Solver);
+	
+	return (error.code == -1 || num_regressions > 0 ? 1 : 0);
+}
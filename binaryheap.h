@@ -0,0 +1,146 @@
+#ifndef _T_BINARY_HEAP_
+#define _T_BINARY_HEAP_
+
+#include <stdlib.h>
+#include "error.h"
+#include "types.h"
+
+//*****************************************************************************************
+// BINARYHEAP STRUCTURE
+/*
+	Binary min-heap (https://en.wikipedia.org/wiki/Binary_heap) of integers with keys of type 'priceType',
+	stored in arrays. As in 'BoundedDeque', the maximum number of elements is fixed until a new maximum size
+	is requested via 'BH_AllocateMemory' (this resets the heap to empty). The elements with equal keys leave
+	the heap in no particular order.
+*/
+typedef struct
+{
+	// The maximum number of elements of the heap.
+	int			max_length;
+	// The number of elements of the heap.
+	int			length;
+	// The elements and their keys, in heap order: the key of the element 'k' is not greater than the keys
+	// of the elements '2k+1' and '2k+2'.
+	int			*elements;
+	priceType	*keys;
+} BinaryHeap;
+
+//***********************************
+// BINARYHEAP METHODS
+
+// Constructor: initializes the members to safe default values.
+// This function always needs to be called on a 'BinaryHeap' instance before any other move.
+void	BH_Defaults(BinaryHeap *BH)
+{
+	BH->max_length = 0;
+	BH->length = 0;
+	BH->elements = NULL;
+	BH->keys = NULL;
+}
+
+// Safe destructor: free the memory and set everything to default values.
+void	BH_Clear(BinaryHeap *BH)
+{
+	free((char*) BH->elements);
+	free((char*) BH->keys);
+	BH_Defaults(BH);
+}
+
+// Allocate memory for the maximum capacity of the heap.
+// In case of error, an Error instance will be returned and the heap will have no capacity.
+Error	BH_AllocateMemory(BinaryHeap *BH, int size)
+{
+	Error	error = {1, "OK"};
+	
+	BH_Clear(BH);
+	if (size < 0)
+	{
+		Error_Set(&error, -1, "Error: can not allocate a negative amount of memory in 'BH_AllocateMemory'");
+		return error;
+	}
+	if (size == 0) return error;
+	
+	BH->elements = (int*) malloc(size * sizeof(int));
+	BH->keys = (priceType*) malloc(size * sizeof(priceType));
+	if (BH->elements == NULL || BH->keys == NULL)
+	{
+		BH_Clear(BH);
+		Error_Set(&error, -1, "Error: no memory for the allocation in 'BH_AllocateMemory'");
+		return error;
+	}
+	BH->max_length = size;
+	
+	return error;
+}
+
+// Insert an element with key 'key'.
+// If the heap is already at max size, the element will not be inserted.
+void	BH_Push(BinaryHeap *BH, int data, priceType key)
+{
+	int		position = BH->length;
+	int		parent = 0;
+	
+	if (BH->length >= BH->max_length) return;
+	//Move the parents with bigger keys down until the place of the new element is found.
+	while (position > 0)
+	{
+		parent = (position - 1) / 2;
+		if (BH->keys[parent] <= key) break;
+		BH->elements[position] = BH->elements[parent];
+		BH->keys[position] = BH->keys[parent];
+		position = parent;
+	}
+	BH->elements[position] = data;
+	BH->keys[position] = key;
+	++BH->length;
+}
+
+// Remove an element with the smallest key, returning such element in the reference argument 'data'.
+// In case of error, an Error instance will be returned.
+Error	BH_Pop(BinaryHeap *BH, int *data)
+{
+	Error		error = {1, "OK"};
+	int			position = 0;
+	int			child = 0;
+	int			last_element = 0;
+	priceType	last_key = 0;
+	
+	if (BH->length <= 0)
+	{
+		Error_Set(&error, -1, "Error: the heap is empty in 'BH_Pop'");
+		return error;
+	}
+	*data = BH->elements[0];
+	--BH->length;
+	last_element = BH->elements[BH->length];
+	last_key = BH->keys[BH->length];
+	//Move the children with smaller keys up until the place of the last element is found.
+	while ((child = 2 * position + 1) < BH->length)
+	{
+		if (child + 1 < BH->length && BH->keys[child + 1] < BH->keys[child]) ++child;
+		if (last_key <= BH->keys[child]) break;
+		BH->elements[position] = BH->elements[child];
+		BH->keys[position] = BH->keys[child];
+		position = child;
+	}
+	BH->elements[position] = last_element;
+	BH->keys[position] = last_key;
+	
+	return error;
+}
+
+// The position in 'elements' of an element with the second smallest key. The heap must have at least two elements.
+int		BH_Second_position(const BinaryHeap *BH)
+{
+	return (BH->length > 2 && BH->keys[2] < BH->keys[1] ? 2 : 1);
+}
+
+// Empty the heap.
+void	BH_Reset(BinaryHeap *BH)
+{
+	BH->length = 0;
+}
+
+//*****************************************************************************************
+
+#endif
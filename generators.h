@@ -0,0 +1,256 @@
+#ifndef _T_GENERATORS_
+#define _T_GENERATORS_
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "error.h"
+#include "types.h"
+
+//*****************************************************************************************
+// INSTANCE GENERATORS
+/*
+	Generators of reproducible families of weighted bipartite graphs with 'n' persons and 'n' objects,
+	used to benchmark the solver. The same seed always gives the same graph on any machine, since the
+	random numbers come from the 'splitmix64' generator below instead of 'rand'.
+	The costs are integers in {0, ..., max_cost}. Except in the dense family each person 'i' is always
+	adjacent to the object 'Mates[i]' of a random permutation, so every graph has a perfect matching.
+	The families are:
+	- GEN_DENSE: complete graph with uniform costs.
+	- GEN_SPARSE: each person has a uniform random degree in {1, ..., 2 * degree - 1} (so 'degree' on
+	  average), with random objects and uniform costs.
+	- GEN_GEOMETRIC: the persons and the objects are random points of the unit square, each person is
+	  adjacent to the objects of the nearby cells of a grid ('degree' of them on average) and the cost
+	  is proportional to the distance.
+	- GEN_HARD: all the persons compete for the same 'degree' cheap objects, and the rest of them have to
+	  settle for their object 'Mates[i]', which is expensive. The auction goes through long price wars.
+*/
+
+#define GEN_DENSE		0
+#define GEN_SPARSE		1
+#define GEN_GEOMETRIC	2
+#define GEN_HARD		3
+#define GEN_NUM_FAMILIES	4
+
+// The names of the families, indexed by their 'GEN_*' values.
+const char *GEN_FAMILY_NAMES[GEN_NUM_FAMILIES] = {"dense", "sparse", "geometric", "hard"};
+
+// Returns the 'GEN_*' value of a family given its name, or '-1' if there is no family with that name.
+int		GEN_Family_from_name(const char *name)
+{
+	for(int family = 0; family < GEN_NUM_FAMILIES; ++family)
+		if (strcmp(name, GEN_FAMILY_NAMES[family]) == 0) return family;
+	return -1;
+}
+
+// Next value of the 'splitmix64' generator with state 'state'.
+unsigned long long	GEN_Random(unsigned long long *state)
+{
+	unsigned long long	z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// Uniform random integer in {0, ..., limit - 1}.
+int		GEN_Random_int(unsigned long long *state, int limit)
+{
+	return (int)(GEN_Random(state) % (unsigned long long)limit);
+}
+
+// Uniform random number in [0, 1).
+double	GEN_Random_double(unsigned long long *state)
+{
+	return (GEN_Random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Free the auxiliary arrays of 'GEN_Generate'.
+void	GEN_Free_workspace(int *Mates, int *Degrees, int *Last_person, double *Points, int *Cell_offsets, int *Cell_objects)
+{
+	free((char*) Mates);
+	free((char*) Degrees);
+	free((char*) Last_person);
+	free((char*) Points);
+	free((char*) Cell_offsets);
+	free((char*) Cell_objects);
+}
+
+// Generate the graph of the family 'family' with 'n' persons and objects, average degree 'degree' (or number
+// of cheap objects in GEN_HARD), costs up to 'max_cost' and random seed 'seed', and store it in 'G'.
+// In case of error, an Error instance will be returned and the Graph will be empty.
+Error	GEN_Generate(Graph *G, int family, int n, int degree, int max_cost, unsigned long long seed)
+{
+	Error				error = {1, "OK"};
+	unsigned long long	state = seed;
+	// A random permutation that gives a perfect matching, the degrees of the persons, and the last person
+	// adjacent to each object (to avoid repeated edges).
+	int					*Mates = NULL;
+	int					*Degrees = NULL;
+	int					*Last_person = NULL;
+	// The points of the persons and the objects, and the objects sorted by grid cell, for GEN_GEOMETRIC.
+	double				*Points = NULL;
+	int					*Cell_offsets = NULL;
+	int					*Cell_objects = NULL;
+	int					grid_size = 1;
+	long int			num_edges = 0;
+	int					k = 0;
+	int					j = 0;
+	int					swap = 0;
+	int					cx = 0;
+	int					cy = 0;
+	
+	if (n <= 0 || degree <= 0 || max_cost < 0 || family < 0 || family >= GEN_NUM_FAMILIES)
+	{
+		Graph_Clear(G);
+		Error_Set(&error, -1, "Error: wrong parameters in 'GEN_Generate'");
+		return error;
+	}
+	if (degree > n) degree = n;
+	
+	Mates = (int*) malloc(n * sizeof(int));
+	Degrees = (int*) malloc(n * sizeof(int));
+	Last_person = (int*) malloc(n * sizeof(int));
+	if (family == GEN_GEOMETRIC)
+	{
+		grid_size = (int)ceil(sqrt(9.0 * n / degree));
+		Points = (double*) malloc(4 * (long int)n * sizeof(double));
+		Cell_offsets = (int*) calloc((long int)grid_size * grid_size + 1, sizeof(int));
+		Cell_objects = (int*) malloc(n * sizeof(int));
+	}
+	if (Mates == NULL || Degrees == NULL || Last_person == NULL
+		|| (family == GEN_GEOMETRIC && (Points == NULL || Cell_offsets == NULL || Cell_objects == NULL)))
+	{
+		Error_Set(&error, -1, "Error: no memory for the allocation in 'GEN_Generate'");
+		GEN_Free_workspace(Mates, Degrees, Last_person, Points, Cell_offsets, Cell_objects);
+		Graph_Clear(G);
+		return error;
+	}
+	
+	// The random permutation (Fisher-Yates).
+	for(int i = 0; i < n; ++i) Mates[i] = i;
+	for(int i = n - 1; i > 0; --i)
+	{
+		j = GEN_Random_int(&state, i + 1);
+		swap = Mates[i];
+		Mates[i] = Mates[j];
+		Mates[j] = swap;
+	}
+	
+	// The geometric family places the objects in the cells of the grid (counting sort), and the
+	// degree of each person is the number of objects in the 3x3 cells around it, plus its mate.
+	if (family == GEN_GEOMETRIC)
+	{
+		for(int p = 0; p < 2 * n; ++p)
+		{
+			Points[2 * p] = GEN_Random_double(&state);
+			Points[2 * p + 1] = GEN_Random_double(&state);
+		}
+		// The objects are the points 'n, ..., 2n - 1'.
+		for(int o = 0; o < n; ++o)
+			++Cell_offsets[(int)(Points[2 * (n + o) + 1] * grid_size) * grid_size + (int)(Points[2 * (n + o)] * grid_size) + 1];
+		for(int c = 0; c < grid_size * grid_size; ++c) Cell_offsets[c + 1] += Cell_offsets[c];
+		for(int o = 0; o < n; ++o)
+		{
+			k = (int)(Points[2 * (n + o) + 1] * grid_size) * grid_size + (int)(Points[2 * (n + o)] * grid_size);
+			Cell_objects[Cell_offsets[k]++] = o;
+		}
+		for(int c = grid_size * grid_size; c > 0; --c) Cell_offsets[c] = Cell_offsets[c - 1];
+		Cell_offsets[0] = 0;
+	}
+	
+	// The degree of each person.
+	for(int i = 0; i < n; ++i)
+	{
+		if (family == GEN_DENSE) Degrees[i] = n;
+		else if (family == GEN_SPARSE) Degrees[i] = 1 + GEN_Random_int(&state, 2 * degree - 1);
+		else if (family == GEN_HARD) Degrees[i] = degree + 1;
+		else
+		{
+			Degrees[i] = 1;
+			cx = (int)(Points[2 * i] * grid_size);
+			cy = (int)(Points[2 * i + 1] * grid_size);
+			for(int y = (cy > 0 ? cy - 1 : 0); y <= cy + 1 && y < grid_size; ++y)
+				for(int x = (cx > 0 ? cx - 1 : 0); x <= cx + 1 && x < grid_size; ++x)
+					for(int c = Cell_offsets[y * grid_size + x]; c < Cell_offsets[y * grid_size + x + 1]; ++c)
+						Degrees[i] += (Cell_objects[c] != Mates[i]);
+		}
+		if (Degrees[i] > n) Degrees[i] = n;
+		num_edges += Degrees[i];
+	}
+	if (num_edges > 2147483647) Error_Set(&error, -1, "Error: the graph has too many edges in 'GEN_Generate'");
+	else error = Graph_Allocate(G, n, (int)num_edges);
+	if (error.code == -1)
+	{
+		if (num_edges <= 2147483647) strcat(error.msg, " In 'GEN_Generate'");
+		GEN_Free_workspace(Mates, Degrees, Last_person, Points, Cell_offsets, Cell_objects);
+		Graph_Clear(G);
+		return error;
+	}
+	for(int i = 0; i < n; ++i) G->offsets[i + 1] = G->offsets[i] + Degrees[i];
+	
+	// The adjacency lists.
+	for(int o = 0; o < n; ++o) Last_person[o] = -1;
+	for(int i = 0; i < n; ++i)
+	{
+		k = G->offsets[i];
+		if (family == GEN_DENSE)
+		{
+			for(int o = 0; o < n; ++o, ++k)
+			{
+				G->neighbors[k] = o;
+				G->costs[k] = (costType)GEN_Random_int(&state, max_cost + 1);
+			}
+			continue;
+		}
+		
+		// The mate first, then the other neighbors.
+		G->neighbors[k] = Mates[i];
+		Last_person[Mates[i]] = i;
+		if (family == GEN_HARD) G->costs[k] = (costType)(max_cost - GEN_Random_int(&state, max_cost / 10 + 1));
+		else if (family == GEN_SPARSE) G->costs[k] = (costType)GEN_Random_int(&state, max_cost + 1);
+		++k;
+		if (family == GEN_SPARSE)
+			while(k < G->offsets[i + 1])
+			{
+				j = GEN_Random_int(&state, n);
+				if (Last_person[j] == i) continue;
+				Last_person[j] = i;
+				G->neighbors[k] = j;
+				G->costs[k++] = (costType)GEN_Random_int(&state, max_cost + 1);
+			}
+		else if (family == GEN_HARD)
+		{
+			// The cheap objects are '0, ..., degree - 1' (one of them is replaced by 'degree' if it is the mate).
+			for(int o = 0; k < G->offsets[i + 1]; ++o)
+			{
+				if (o == Mates[i]) continue;
+				G->neighbors[k] = o;
+				G->costs[k++] = (costType)GEN_Random_int(&state, max_cost / 100 + 1);
+			}
+		}
+		else
+		{
+			cx = (int)(Points[2 * i] * grid_size);
+			cy = (int)(Points[2 * i + 1] * grid_size);
+			for(int y = (cy > 0 ? cy - 1 : 0); y <= cy + 1 && y < grid_size; ++y)
+				for(int x = (cx > 0 ? cx - 1 : 0); x <= cx + 1 && x < grid_size; ++x)
+					for(int c = Cell_offsets[y * grid_size + x]; c < Cell_offsets[y * grid_size + x + 1]; ++c)
+						if (Cell_objects[c] != Mates[i]) G->neighbors[k++] = Cell_objects[c];
+			// The costs are the distances, scaled so that the diagonal of the square costs 'max_cost'.
+			for(k = G->offsets[i]; k < G->offsets[i + 1]; ++k)
+			{
+				j = n + G->neighbors[k];
+				G->costs[k] = (costType)floor(max_cost * hypot(Points[2 * i] - Points[2 * j], Points[2 * i + 1] - Points[2 * j + 1])
+					/ sqrt(2.0) + 0.5);
+			}
+		}
+	}
+	Graph_Check_dense(G, n);
+	
+	GEN_Free_workspace(Mates, Degrees, Last_person, Points, Cell_offsets, Cell_objects);
+	return error;
+}
+
+//*****************************************************************************************
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef _T_HOPCROFT_KARP_
+#define _T_HOPCROFT_KARP_
+
+#include <stdlib.h>
+#include "error.h"
+#include "types.h"
+
+//*****************************************************************************************
+// MAXIMUM CARDINALITY MATCHING
+/*
+	Hopcroft-Karp algorithm (https://en.wikipedia.org/wiki/Hopcroft%E2%80%93Karp_algorithm) on the
+	adjacency lists of a 'Graph', ignoring the costs. It runs in O(E sqrt(V)) time, after a greedy
+	initial matching, and the depth first searches use an explicit stack so that long augmenting paths
+	do not overflow the call stack on big graphs.
+	It is used to know in advance whether the graph has a perfect matching, since otherwise the
+	Auction algorithm would never end.
+*/
+
+// Value of the distance of the persons not reached by the breadth first search.
+#define HK_UNREACHED	2147483647
+
+// Number of int elements of the workspace of 'HK_Maximum_matching' for 'num_persons' persons and 'num_objects' objects.
+#define HK_WORKSPACE_SIZE(num_persons, num_objects)	(5 * (long int)(num_persons) + (num_objects) + 1)
+
+// Find a maximum cardinality matching of the graph 'G', with 'num_objects' objects, and return its size by
+// reference in 'cardinality'. If 'Person_mates' is not NULL, it must have 'G->num_persons' elements and the
+// object matched to each person is returned in it (or -1 for the unmatched persons).
+// If 'workspace' is not NULL, it must have 'HK_WORKSPACE_SIZE(G->num_persons, num_objects)' elements and no memory
+// is allocated.
+// In case of error, an Error instance will be returned.
+Error	HK_Maximum_matching(const Graph *G, int num_objects, int *cardinality, int *Person_mates, int *workspace)
+{
+	Error	error = {1, "OK"};
+	int		num_persons = G->num_persons;
+	// The mates of the persons and of the objects, -1 if unmatched.
+	int		*mate_of_person = NULL;
+	int		*mate_of_object = NULL;
+	// The BFS layer of each person, the BFS queue and the DFS stack.
+	int		*distance = NULL;
+	int		*queue = NULL;
+	int		*stack = NULL;
+	// The next edge to explore of each person in the DFS.
+	int		*next_edge = NULL;
+	int		queue_begin = 0;
+	int		queue_end = 0;
+	int		top = 0;
+	int		free_distance = 0;
+	int		person_i = 0;
+	int		object_j = 0;
+	int		mate = 0;
+	
+	*cardinality = 0;
+	if (workspace == NULL)
+	{
+		mate_of_person = (int*) malloc(HK_WORKSPACE_SIZE(num_persons, num_objects) * sizeof(int));
+		if (mate_of_person == NULL)
+		{
+			Error_Set(&error, -1, "Error: no memory for the allocation in 'HK_Maximum_matching'");
+			return error;
+		}
+	}
+	else mate_of_person = workspace;
+	distance = mate_of_person + num_persons;
+	queue = distance + num_persons;
+	stack = queue + num_persons;
+	next_edge = stack + num_persons;
+	mate_of_object = next_edge + num_persons;
+	
+	// Greedy initial matching.
+	for(object_j = 0; object_j < num_objects; ++object_j) mate_of_object[object_j] = -1;
+	for(person_i = 0; person_i < num_persons; ++person_i)
+	{
+		mate_of_person[person_i] = -1;
+		for(int k = G->offsets[person_i]; k < G->offsets[person_i + 1]; ++k)
+			if (mate_of_object[Graph_Neighbor(G, person_i, k)] == -1)
+			{
+				mate_of_person[person_i] = Graph_Neighbor(G, person_i, k);
+				mate_of_object[Graph_Neighbor(G, person_i, k)] = person_i;
+				++*cardinality;
+				break;
+			}
+	}
+	
+	while(*cardinality < num_persons)
+	{
+		// Breadth first search from the unmatched persons, by alternating paths. It stops at the layer
+		// where the first unmatched object is found ('free_distance').
+		queue_begin = 0;
+		queue_end = 0;
+		free_distance = HK_UNREACHED;
+		for(person_i = 0; person_i < num_persons; ++person_i)
+		{
+			if (mate_of_person[person_i] == -1)
+			{
+				distance[person_i] = 0;
+				queue[queue_end++] = person_i;
+			}
+			else distance[person_i] = HK_UNREACHED;
+		}
+		while(queue_begin < queue_end)
+		{
+			person_i = queue[queue_begin++];
+			if (distance[person_i] >= free_distance) continue;
+			for(int k = G->offsets[person_i]; k < G->offsets[person_i + 1]; ++k)
+			{
+				mate = mate_of_object[Graph_Neighbor(G, person_i, k)];
+				if (mate == -1)
+				{
+					if (free_distance == HK_UNREACHED) free_distance = distance[person_i] + 1;
+				}
+				else if (distance[mate] == HK_UNREACHED)
+				{
+					distance[mate] = distance[person_i] + 1;
+					queue[queue_end++] = mate;
+				}
+			}
+		}
+		// No augmenting path: the matching is maximum.
+		if (free_distance == HK_UNREACHED) break;
+		
+		// Depth first search from each unmatched person along the layers, augmenting the vertex disjoint
+		// shortest augmenting paths.
+		for(person_i = 0; person_i < num_persons; ++person_i)
+			next_edge[person_i] = G->offsets[person_i];
+		for(int root = 0; root < num_persons; ++root)
+		{
+			if (mate_of_person[root] != -1) continue;
+			top = 0;
+			stack[top++] = root;
+			while(top > 0)
+			{
+				person_i = stack[top - 1];
+				// All the edges of the person failed: remove it from the layers and go back.
+				if (next_edge[person_i] == G->offsets[person_i + 1])
+				{
+					distance[person_i] = HK_UNREACHED;
+					--top;
+					if (top > 0) ++next_edge[stack[top - 1]];
+					continue;
+				}
+				object_j = Graph_Neighbor(G, person_i, next_edge[person_i]);
+				mate = mate_of_object[object_j];
+				if (mate == -1 && distance[person_i] + 1 == free_distance)
+				{
+					// Augment along the path in the stack: each person takes the object of its current edge.
+					for(int s = top - 1; s >= 0; --s)
+					{
+						person_i = stack[s];
+						object_j = Graph_Neighbor(G, person_i, next_edge[person_i]);
+						mate_of_person[person_i] = object_j;
+						mate_of_object[object_j] = person_i;
+					}
+					++*cardinality;
+					top = 0;
+				}
+				else if (mate != -1 && distance[mate] == distance[person_i] + 1) stack[top++] = mate;
+				else ++next_edge[person_i];
+			}
+		}
+	}
+	
+	if (Person_mates != NULL)
+		for(person_i = 0; person_i < num_persons; ++person_i) Person_mates[person_i] = mate_of_person[person_i];
+	
+	if (workspace == NULL) free((char*) mate_of_person);
+	return error;
+}
+
+//*****************************************************************************************
+
+#endif
@@ -0,0 +1,259 @@
+#ifndef _T_NUMA_PLACEMENT_
+#define _T_NUMA_PLACEMENT_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#include "error.h"
+
+//*****************************************************************************************
+// NUMAPLACEMENT STRUCTURE
+/*
+	Placement of the threads and of the memory of a parallel solve on the NUMA nodes of the machine.
+	The threads are spread in blocks over the nodes (the first threads on the first node, and so on) and each
+	one is pinned to a CPU of its node, so that the memory it touches first stays local to it. The arrays read
+	by all the threads at random positions are interleaved over the nodes, so that their traffic is shared by
+	all the memory controllers.
+	The topology is read from '/sys/devices/system/node' and the system calls are done directly, so it does
+	not need 'libnuma'. On other systems, or without the permission to do it, nothing is pinned nor moved and
+	the solve works as without placement.
+*/
+
+// Maximum number of CPUs and of nodes of the masks of the system calls.
+#define NP_MAX_CPUS		1024
+#define NP_MAX_NODES	64
+#define NP_MASK_WORDS	(NP_MAX_CPUS / (8 * sizeof(unsigned long)))
+
+// The memory policy and the flag of 'mbind' to interleave pages, also moving the ones already touched
+// (the values of <numaif.h>).
+#define NP_MPOL_INTERLEAVE	3
+#define NP_MPOL_MF_MOVE		(1 << 1)
+
+typedef struct
+{
+	// The number of NUMA nodes with CPUs that the process may use ('1' on a machine without NUMA).
+	int				num_nodes;
+	// The number of threads of the placement, and the CPU ('-1' if the thread is not pinned) and the node of each thread.
+	int				num_threads;
+	int				*Thread_cpus;
+	int				*Thread_nodes;
+	// The number of threads that could be pinned to their CPUs in the last placement.
+	int				num_pinned;
+	// The number of bytes interleaved over the nodes in the last placement.
+	long int		interleaved_bytes;
+	// The CPUs the calling thread could use before it was pinned, restored by 'NP_Restore_caller'.
+	unsigned long	Caller_mask[NP_MASK_WORDS];
+	int				caller_pinned;
+} NumaPlacement;
+
+//***********************************
+// NUMAPLACEMENT METHODS
+
+// Constructor: initializes the members to safe default values.
+// This function always needs to be called on a 'NumaPlacement' instance before any other move.
+void	NP_Defaults(NumaPlacement *NP)
+{
+	NP->num_nodes = 1;
+	NP->num_threads = 0;
+	NP->Thread_cpus = NULL;
+	NP->Thread_nodes = NULL;
+	NP->num_pinned = 0;
+	NP->interleaved_bytes = 0;
+	NP->caller_pinned = 0;
+}
+
+// Safe destructor: free the memory and set everything to default values.
+void	NP_Clear(NumaPlacement *NP)
+{
+	free((char*) NP->Thread_cpus);
+	free((char*) NP->Thread_nodes);
+	NP_Defaults(NP);
+}
+
+// Read the list of CPUs or of nodes of the file 'file_path', written as "0-3,8,10-11", into the mask 'mask' of
+// 'max_bits' bits. Returns the number of elements of the list, or '-1' if the file can not be read.
+int		NP_Read_list(const char *file_path, unsigned long *mask, int max_bits)
+{
+	FILE	*input_file;
+	int		first = 0;
+	int		last = 0;
+	int		count = 0;
+	char	separator = 0;
+	
+	memset(mask, 0, (max_bits + 8 * sizeof(unsigned long) - 1) / (8 * sizeof(unsigned long)) * sizeof(unsigned long));
+	input_file = fopen(file_path, "r");
+	if (input_file == NULL) return -1;
+	while (fscanf(input_file, "%d", &first) == 1)
+	{
+		last = first;
+		separator = (char) fgetc(input_file);
+		if (separator == '-')
+		{
+			if (fscanf(input_file, "%d", &last) != 1) break;
+			separator = (char) fgetc(input_file);
+		}
+		for (int element = first; element <= last && element < max_bits; ++element)
+		{
+			mask[element / (8 * sizeof(unsigned long))] |= 1UL << (element % (8 * sizeof(unsigned long)));
+			++count;
+		}
+		if (separator != ',') break;
+	}
+	fclose(input_file);
+	return count;
+}
+
+// '1' if the bit 'bit' of the mask 'mask' is set.
+int		NP_Mask_bit(const unsigned long *mask, int bit)
+{
+	return (int)((mask[bit / (8 * sizeof(unsigned long))] >> (bit % (8 * sizeof(unsigned long)))) & 1UL);
+}
+
+// Plan the placement of 'num_threads' threads: the CPU and the node of each one. Only the CPUs that the calling thread
+// may use are taken, and the nodes without any of them are skipped. Each node gets a block of consecutive threads, in
+// proportion to its number of CPUs, and its threads take its CPUs one after the other.
+// In case of error, an Error instance will be returned and there is no placement.
+Error	NP_Plan(NumaPlacement *NP, int num_threads)
+{
+	Error			error = {1, "OK"};
+	unsigned long	Allowed[NP_MASK_WORDS];
+	unsigned long	Node_cpus[NP_MASK_WORDS];
+	unsigned long	Online_nodes[NP_MAX_NODES / (8 * sizeof(unsigned long)) + 1];
+	// The CPUs of the process grouped by node, and the beginning of the CPUs of each node.
+	int				Cpus[NP_MAX_CPUS];
+	int				Cpus_offsets[NP_MAX_NODES + 1];
+	int				Nodes[NP_MAX_NODES];
+	char			file_path[64];
+	int				num_cpus = 0;
+	int				node_i = 0;
+	// The first thread of the node 'node_i'.
+	int				first_thread = 0;
+	
+	NP_Clear(NP);
+	NP->Thread_cpus = (int*) malloc(num_threads * sizeof(int));
+	NP->Thread_nodes = (int*) malloc(num_threads * sizeof(int));
+	if (NP->Thread_cpus == NULL || NP->Thread_nodes == NULL)
+	{
+		NP_Clear(NP);
+		Error_Set(&error, -1, "Error: no memory for the allocation in 'NP_Plan'");
+		return error;
+	}
+	NP->num_threads = num_threads;
+	
+	//The CPUs the process may use, all of them if they can not be known.
+	memset(Allowed, 0, sizeof(Allowed));
+#ifdef __linux__
+	if (syscall(SYS_sched_getaffinity, 0, sizeof(Allowed), Allowed) < 0)
+#endif
+		memset(Allowed, 0xff, sizeof(Allowed));
+	memcpy(NP->Caller_mask, Allowed, sizeof(Allowed));
+	
+	//The CPUs of each node. Without the nodes in '/sys' the machine is a single node.
+	NP->num_nodes = 0;
+	Cpus_offsets[0] = 0;
+	if (NP_Read_list("/sys/devices/system/node/online", Online_nodes, NP_MAX_NODES) > 0)
+	{
+		for (int node = 0; node < NP_MAX_NODES; ++node)
+		{
+			if (!NP_Mask_bit(Online_nodes, node)) continue;
+			snprintf(file_path, sizeof(file_path), "/sys/devices/system/node/node%d/cpulist", node);
+			if (NP_Read_list(file_path, Node_cpus, NP_MAX_CPUS) <= 0) continue;
+			for (int cpu = 0; cpu < NP_MAX_CPUS; ++cpu)
+				if (NP_Mask_bit(Node_cpus, cpu) && NP_Mask_bit(Allowed, cpu)) Cpus[num_cpus++] = cpu;
+			if (num_cpus == Cpus_offsets[NP->num_nodes]) continue;
+			Nodes[NP->num_nodes] = node;
+			Cpus_offsets[++NP->num_nodes] = num_cpus;
+		}
+	}
+	if (NP->num_nodes == 0)
+	{
+		long int	online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		
+		for (int cpu = 0; cpu < NP_MAX_CPUS && cpu < online_cpus; ++cpu)
+			if (NP_Mask_bit(Allowed, cpu)) Cpus[num_cpus++] = cpu;
+		Nodes[0] = 0;
+		Cpus_offsets[1] = num_cpus;
+		NP->num_nodes = 1;
+	}
+	
+	//The blocks of threads of the nodes. Without any known CPU the threads are not pinned.
+	for (int thread_i = 0; thread_i < num_threads; ++thread_i)
+	{
+		if (num_cpus == 0)
+		{
+			NP->Thread_cpus[thread_i] = -1;
+			NP->Thread_nodes[thread_i] = 0;
+			continue;
+		}
+		while (node_i < NP->num_nodes - 1 && (long int)thread_i * num_cpus >= (long int)Cpus_offsets[node_i + 1] * num_threads)
+		{
+			++node_i;
+			first_thread = thread_i;
+		}
+		NP->Thread_nodes[thread_i] = Nodes[node_i];
+		NP->Thread_cpus[thread_i] = Cpus[Cpus_offsets[node_i] + (thread_i - first_thread) % (Cpus_offsets[node_i + 1] - Cpus_offsets[node_i])];
+	}
+	
+	return error;
+}
+
+// Pin the calling thread to the CPU of the thread 'thread_i' of the placement. The thread '0' is the one that plans
+// the placement, and it can be unpinned with 'NP_Restore_caller'. Returns '1' if the thread was pinned, otherwise its
+// CPU is set to '-1' (each thread only writes its own element, so all the threads can pin themselves at once).
+int		NP_Pin_thread(NumaPlacement *NP, int thread_i)
+{
+	unsigned long	mask[NP_MASK_WORDS];
+	int				cpu = (thread_i < NP->num_threads ? NP->Thread_cpus[thread_i] : -1);
+	
+	if (cpu < 0) return 0;
+	memset(mask, 0, sizeof(mask));
+	mask[cpu / (8 * sizeof(unsigned long))] = 1UL << (cpu % (8 * sizeof(unsigned long)));
+#ifdef __linux__
+	if (syscall(SYS_sched_setaffinity, 0, sizeof(mask), mask) == 0)
+	{
+		if (thread_i == 0) NP->caller_pinned = 1;
+		return 1;
+	}
+#endif
+	NP->Thread_cpus[thread_i] = -1;
+	return 0;
+}
+
+// Let the calling thread run again on all the CPUs it could use before 'NP_Pin_thread(NP, 0)'.
+void	NP_Restore_caller(NumaPlacement *NP)
+{
+	if (!NP->caller_pinned) return;
+#ifdef __linux__
+	syscall(SYS_sched_setaffinity, 0, sizeof(NP->Caller_mask), NP->Caller_mask);
+#endif
+	NP->caller_pinned = 0;
+}
+
+// Interleave the pages of the array 'array' of 'size' bytes over the nodes of the placement, moving the pages already
+// touched. Only the whole pages inside the array are moved, the ones it shares with other memory are left as they are.
+// Returns the number of bytes interleaved, '0' with a single node or if the system does not allow it.
+long int	NP_Interleave(NumaPlacement *NP, void *array, long int size)
+{
+	unsigned long	Node_mask[NP_MAX_NODES / (8 * sizeof(unsigned long)) + 1];
+	long int		page_size = sysconf(_SC_PAGESIZE);
+	unsigned long	begin = ((unsigned long)array + page_size - 1) / page_size * page_size;
+	unsigned long	end = ((unsigned long)array + size) / page_size * page_size;
+	
+	if (NP->num_nodes <= 1 || array == NULL || page_size <= 0 || end <= begin) return 0;
+	memset(Node_mask, 0, sizeof(Node_mask));
+	for (int thread_i = 0; thread_i < NP->num_threads; ++thread_i)
+		Node_mask[NP->Thread_nodes[thread_i] / (8 * sizeof(unsigned long))] |= 1UL << (NP->Thread_nodes[thread_i] % (8 * sizeof(unsigned long)));
+#ifdef __linux__
+	if (syscall(SYS_mbind, begin, end - begin, NP_MPOL_INTERLEAVE, Node_mask, NP_MAX_NODES + 1, NP_MPOL_MF_MOVE) == 0)
+		return (long int)(end - begin);
+#endif
+	return 0;
+}
+
+//*****************************************************************************************
+
+#endif
@@ -0,0 +1,447 @@
+#ifndef _T_PRESOLVE_
+#define _T_PRESOLVE_
+
+#include <stdio.h>
+#include "error.h"
+#include "types.h"
+#include "AP_Tools.h"
+#include "batchsolver.h"
+
+//*****************************************************************************************
+// PRESOLVER STRUCTURE
+/*
+	Reductions of the graph of an 'AuctionSolver' before the auction, which pay off on sparse graphs:
+	- The vertices with only one neighbor that must be matched force their edge, which is removed with
+	  both vertices, and so on with the vertices whose degree drops to one.
+	- The rest of the graph is split into its connected components, which are solved independently as
+	  the instances of a 'BatchSolver', in parallel.
+	- The minimum cost of the edges of each person is subtracted from its edges, and then the minimum cost
+	  of the edges of each object from its edges. This does not change the optimal matchings, since every
+	  matching has one edge of each of these vertices, but it reduces the range of the costs, which is the
+	  initial epsilon of each component, and so the number of scaling phases.
+	The matching of the components is then mapped back to the original graph.
+	A vertex must be matched when its side of the graph is not bigger than the other one, or when its
+	component is balanced, and only those vertices are forced and reduced. In the maximum cardinality mode
+	no vertex must be matched, so only the components are split.
+*/
+typedef struct
+{
+	// The number of pairs forced by the vertices with one neighbor.
+	int				num_forced;
+	// The connected components of the rest of the graph, with at least one edge: the persons of the component
+	// 'c' are the original persons 'Component_persons[Person_offsets[c]], ..., Component_persons[Person_offsets[c + 1] - 1]',
+	// in the order of their indices in the component, and the same for the objects.
+	int				num_components;
+	int				*Person_offsets;
+	int				*Component_persons;
+	int				*Object_offsets;
+	int				*Component_objects;
+	// The minimum cost subtracted from the edges of each original person and object.
+	costType		*Row_minima;
+	costType		*Column_minima;
+	// The components, as instances of the batch.
+	BatchSolver		Batch;
+	// The wall-clock time in seconds spent in the reductions and the whole solve.
+	double			presolve_time;
+	double			solving_time;
+} Presolver;
+
+//***********************************
+// PRESOLVER METHODS
+
+// Constructor: initializes the members to safe default values.
+// This function always needs to be called on a 'Presolver' instance before any other move.
+void	PS_Defaults(Presolver *Presolve)
+{
+	Presolve->num_forced = 0;
+	Presolve->num_components = 0;
+	Presolve->Person_offsets = NULL;
+	Presolve->Component_persons = NULL;
+	Presolve->Object_offsets = NULL;
+	Presolve->Component_objects = NULL;
+	Presolve->Row_minima = NULL;
+	Presolve->Column_minima = NULL;
+	BS_Defaults(&Presolve->Batch);
+	Presolve->presolve_time = 0;
+	Presolve->solving_time = 0;
+}
+
+// Safe destructor: free the memory and set everything to default values.
+void	PS_Clear(Presolver *Presolve)
+{
+	free((char*) Presolve->Person_offsets);
+	free((char*) Presolve->Component_persons);
+	free((char*) Presolve->Object_offsets);
+	free((char*) Presolve->Component_objects);
+	free((char*) Presolve->Row_minima);
+	free((char*) Presolve->Column_minima);
+	BS_Clear(&Presolve->Batch);
+	PS_Defaults(Presolve);
+}
+
+// The root of the vertex 'v' in the union-find forest 'Parents', halving the path on the way.
+int		PS_Find_root(int *Parents, int v)
+{
+	while (Parents[v] != v)
+	{
+		Parents[v] = Parents[Parents[v]];
+		v = Parents[v];
+	}
+	return v;
+}
+
+// Remove the vertex 'v' of the graph (the persons are '0, ..., num_persons - 1' and the object 'j' is 'num_persons + j')
+// after it was matched: the degrees of its unmatched neighbors in 'Degrees' drop, and the ones that drop to one and must be
+// matched are pushed to 'Queue'. 'Adjacency' is the graph of the side of 'v' and 'Mates' the mates of the other side.
+// Returns '0' if some neighbor that must be matched is left without neighbors, '1' otherwise.
+int		PS_Remove_vertex(const Graph *Adjacency, int v, int first, int *Mates, int *Degrees, int must_match, int *Queue, int *queue_end)
+{
+	int		neighbor = 0;
+	int		feasible = 1;
+	
+	for(int k = Adjacency->offsets[v]; k < Adjacency->offsets[v + 1]; ++k)
+	{
+		neighbor = Graph_Neighbor(Adjacency, v, k);
+		if (Mates[neighbor] != -1) continue;
+		--Degrees[first + neighbor];
+		if (must_match && Degrees[first + neighbor] == 1) Queue[(*queue_end)++] = first + neighbor;
+		if (must_match && Degrees[first + neighbor] == 0) feasible = 0;
+	}
+	return feasible;
+}
+
+// Solve the Assignment Problem of the graph of 'Instance' with the reductions of the presolve and with the options
+// of 'Instance', with the scaling factor 'alpha'. The components are solved with 'Instance->num_threads' threads.
+// The matching, its costs and the matching cost are left in the members of 'Instance' as after 'AS_Solve_Instance',
+// but its prices are not set and it can not be solved again with 'AS_Resolve_Instance'.
+// In case of error, an Error instance will be returned.
+Error	PS_Solve(Presolver *Presolve, AuctionSolver *Instance, double alpha)
+{
+	Error			error = {1, "OK"};
+	double			start_time = Wall_time();
+	// The beginning of the mapping of the matching back to the graph.
+	double			extraction_time = 0;
+	int				num_persons = Instance->num_persons;
+	int				num_objects = Instance->num_objects;
+	Graph			*Persons = &Instance->Persons;
+	// The adjacency lists of the objects.
+	Graph			Objects;
+	// The mates of the persons and the objects, -1 for the unmatched ones.
+	int				*Person_mates = NULL;
+	int				*Object_mates = NULL;
+	// The degrees of the vertices (persons first), and the queue of the vertices with one neighbor.
+	int				*Degrees = NULL;
+	int				*Queue = NULL;
+	int				queue_end = 0;
+	// The union-find forest of the vertices, and then the component of each vertex (or -1) and its index in it.
+	int				*Parents = NULL;
+	int				*Components = NULL;
+	int				*Indices = NULL;
+	// Whether the persons and the objects must be matched.
+	int				persons_must_match = (!Instance->maximum_cardinality && num_persons <= num_objects);
+	int				objects_must_match = (!Instance->maximum_cardinality && num_objects <= num_persons);
+	int				feasible = 1;
+	int				v = 0;
+	int				k = 0;
+	int				c = 0;
+	int				object_j = 0;
+	int				person_i = 0;
+	AuctionSolver	Loader;
+	BS_Instance		*Current;
+	char			name[32];
+	
+	PS_Clear(Presolve);
+	Graph_Defaults(&Objects);
+	AS_Defaults(&Loader);
+	if (num_persons <= 0 || num_objects <= 0)
+	{
+		Error_Set(&error, -1, "Error: The graph can not be empty in 'PS_Solve'");
+		return error;
+	}
+	error = Graph_Transpose(Persons, num_objects, &Objects);
+	Person_mates = (int*) malloc(num_persons * sizeof(int));
+	Object_mates = (int*) malloc(num_objects * sizeof(int));
+	Degrees = (int*) malloc((num_persons + num_objects) * sizeof(int));
+	Queue = (int*) malloc((num_persons + num_objects) * sizeof(int));
+	Parents = (int*) malloc((num_persons + num_objects) * sizeof(int));
+	Components = (int*) malloc((num_persons + num_objects + 2) * sizeof(int));
+	Indices = (int*) malloc((num_persons + num_objects) * sizeof(int));
+	Presolve->Row_minima = (costType*) malloc(num_persons * sizeof(costType));
+	Presolve->Column_minima = (costType*) malloc(num_objects * sizeof(costType));
+	if (error.code == -1 || Person_mates == NULL || Object_mates == NULL || Degrees == NULL || Queue == NULL || Parents == NULL
+		|| Components == NULL || Indices == NULL || Presolve->Row_minima == NULL || Presolve->Column_minima == NULL)
+		Error_Set(&error, -1, "Error: no memory for the allocation in 'PS_Solve'");
+	
+	//Force the edges of the vertices with one neighbor that must be matched.
+	if (error.code == 1)
+	{
+		for(person_i = 0; person_i < num_persons; ++person_i)
+		{
+			Person_mates[person_i] = -1;
+			Degrees[person_i] = Persons->offsets[person_i + 1] - Persons->offsets[person_i];
+			if (persons_must_match && Degrees[person_i] <= 1) Queue[queue_end++] = person_i;
+		}
+		for(object_j = 0; object_j < num_objects; ++object_j)
+		{
+			Object_mates[object_j] = -1;
+			Degrees[num_persons + object_j] = Objects.offsets[object_j + 1] - Objects.offsets[object_j];
+			if (objects_must_match && Degrees[num_persons + object_j] <= 1) Queue[queue_end++] = num_persons + object_j;
+		}
+		while(queue_end > 0 && feasible)
+		{
+			v = Queue[--queue_end];
+			if (v < num_persons)
+			{
+				if (Person_mates[v] != -1) continue;
+				if (Degrees[v] == 0)
+				{
+					feasible = 0;
+					break;
+				}
+				for(k = Persons->offsets[v]; Object_mates[Graph_Neighbor(Persons, v, k)] != -1; ++k);
+				object_j = Graph_Neighbor(Persons, v, k);
+				person_i = v;
+				Presolve->Row_minima[person_i] = Persons->costs[k];
+			}
+			else
+			{
+				if (Object_mates[v - num_persons] != -1) continue;
+				if (Degrees[v] == 0)
+				{
+					feasible = 0;
+					break;
+				}
+				for(k = Objects.offsets[v - num_persons]; Person_mates[Graph_Neighbor(&Objects, v - num_persons, k)] != -1; ++k);
+				person_i = Graph_Neighbor(&Objects, v - num_persons, k);
+				object_j = v - num_persons;
+				Presolve->Row_minima[person_i] = Objects.costs[k];
+			}
+			//The cost of the forced edge is kept as the row minimum of the person.
+			Presolve->Column_minima[object_j] = 0;
+			Person_mates[person_i] = object_j;
+			Object_mates[object_j] = person_i;
+			++Presolve->num_forced;
+			feasible = PS_Remove_vertex(&Objects, object_j, 0, Person_mates, Degrees, persons_must_match, Queue, &queue_end)
+				&& PS_Remove_vertex(Persons, person_i, num_persons, Object_mates, Degrees, objects_must_match, Queue, &queue_end);
+		}
+		if (!feasible)
+			Error_Set(&error, -1, "Error: The graph has no perfect matching, a vertex that must be matched has no neighbors in 'PS_Solve'");
+	}
+	
+	//Join the ends of the edges that are left, and number the components with edges and their vertices.
+	if (error.code == 1)
+	{
+		for(v = 0; v < num_persons + num_objects; ++v) Parents[v] = v;
+		for(person_i = 0; person_i < num_persons; ++person_i)
+		{
+			if (Person_mates[person_i] != -1) continue;
+			for(k = Persons->offsets[person_i]; k < Persons->offsets[person_i + 1]; ++k)
+			{
+				object_j = Graph_Neighbor(Persons, person_i, k);
+				if (Object_mates[object_j] == -1)
+					Parents[PS_Find_root(Parents, num_persons + object_j)] = PS_Find_root(Parents, person_i);
+			}
+		}
+		//'Components' is the component of each root first, then of each vertex.
+		for(v = 0; v < num_persons + num_objects; ++v) Components[v] = -1;
+		for(v = 0; v < num_persons + num_objects; ++v)
+		{
+			if (Degrees[v] == 0 || (v < num_persons ? Person_mates[v] : Object_mates[v - num_persons]) != -1) continue;
+			if (Components[PS_Find_root(Parents, v)] == -1) Components[PS_Find_root(Parents, v)] = Presolve->num_components++;
+		}
+		for(v = 0; v < num_persons + num_objects; ++v)
+			Indices[v] = ((Degrees[v] == 0 || (v < num_persons ? Person_mates[v] : Object_mates[v - num_persons]) != -1) ? -1
+				: Components[PS_Find_root(Parents, v)]);
+		for(v = 0; v < num_persons + num_objects; ++v) Components[v] = Indices[v];
+		
+		Presolve->Person_offsets = (int*) calloc(Presolve->num_components + 1, sizeof(int));
+		Presolve->Object_offsets = (int*) calloc(Presolve->num_components + 1, sizeof(int));
+		Presolve->Component_persons = (int*) malloc((num_persons + 1) * sizeof(int));
+		Presolve->Component_objects = (int*) malloc((num_objects + 1) * sizeof(int));
+		if (Presolve->Person_offsets == NULL || Presolve->Object_offsets == NULL || Presolve->Component_persons == NULL
+			|| Presolve->Component_objects == NULL)
+			Error_Set(&error, -1, "Error: no memory for the allocation of the components in 'PS_Solve'");
+	}
+	
+	//The vertices of each component, in increasing order (counting sort).
+	if (error.code == 1)
+	{
+		for(v = 0; v < num_persons + num_objects; ++v)
+		{
+			if (Components[v] == -1) continue;
+			if (v < num_persons) ++Presolve->Person_offsets[Components[v] + 1];
+			else ++Presolve->Object_offsets[Components[v] + 1];
+		}
+		for(c = 0; c < Presolve->num_components; ++c)
+		{
+			Presolve->Person_offsets[c + 1] += Presolve->Person_offsets[c];
+			Presolve->Object_offsets[c + 1] += Presolve->Object_offsets[c];
+		}
+		for(v = 0; v < num_persons + num_objects; ++v)
+		{
+			if (Components[v] == -1) continue;
+			if (v < num_persons)
+			{
+				Indices[v] = Presolve->Person_offsets[Components[v]]++;
+				Presolve->Component_persons[Indices[v]] = v;
+			}
+			else
+			{
+				Indices[v] = Presolve->Object_offsets[Components[v]]++;
+				Presolve->Component_objects[Indices[v]] = v - num_persons;
+			}
+		}
+		for(c = Presolve->num_components; c > 0; --c)
+		{
+			Presolve->Person_offsets[c] = Presolve->Person_offsets[c - 1];
+			Presolve->Object_offsets[c] = Presolve->Object_offsets[c - 1];
+		}
+		Presolve->Person_offsets[0] = 0;
+		Presolve->Object_offsets[0] = 0;
+		for(v = 0; v < num_persons + num_objects; ++v)
+			if (Components[v] != -1) Indices[v] -= (v < num_persons ? Presolve->Person_offsets : Presolve->Object_offsets)[Components[v]];
+	}
+	
+	//Build the graph of each component with the reduced costs, and add it to the batch.
+	for(c = 0; c < Presolve->num_components && error.code == 1; ++c)
+	{
+		int		component_persons = Presolve->Person_offsets[c + 1] - Presolve->Person_offsets[c];
+		int		component_objects = Presolve->Object_offsets[c + 1] - Presolve->Object_offsets[c];
+		int		reduce_rows = persons_must_match || (objects_must_match && component_persons == component_objects);
+		int		reduce_columns = objects_must_match || (persons_must_match && component_persons == component_objects);
+		int		num_edges = 0;
+		costType	reduced_cost = 0;
+		
+		if ((persons_must_match && component_persons > component_objects) || (objects_must_match && component_objects > component_persons))
+		{
+			snprintf(error.msg, sizeof(error.msg), "Error: The graph has no perfect matching, its component %d has %d persons and %d objects in 'PS_Solve'",
+				c, component_persons, component_objects);
+			error.code = -1;
+			break;
+		}
+		for(int p = Presolve->Person_offsets[c]; p < Presolve->Person_offsets[c + 1]; ++p)
+			num_edges += Degrees[Presolve->Component_persons[p]];
+		error = Graph_Allocate(&Loader.Persons, component_persons, num_edges);
+		if (error.code == -1)
+		{
+			strcat(error.msg, " In 'PS_Solve'");
+			break;
+		}
+		
+		//The row minima, and the edges with them subtracted.
+		for(int p = 0; p < component_persons; ++p)
+		{
+			person_i = Presolve->Component_persons[Presolve->Person_offsets[c] + p];
+			Presolve->Row_minima[person_i] = 0;
+			Loader.Persons.offsets[p + 1] = Loader.Persons.offsets[p];
+			for(k = Persons->offsets[person_i]; k < Persons->offsets[person_i + 1]; ++k)
+			{
+				object_j = Graph_Neighbor(Persons, person_i, k);
+				if (Object_mates[object_j] != -1) continue;
+				if (reduce_rows && (Loader.Persons.offsets[p + 1] == Loader.Persons.offsets[p] || Persons->costs[k] < Presolve->Row_minima[person_i]))
+					Presolve->Row_minima[person_i] = Persons->costs[k];
+				Loader.Persons.neighbors[Loader.Persons.offsets[p + 1]] = Indices[num_persons + object_j];
+				Loader.Persons.costs[Loader.Persons.offsets[p + 1]++] = Persons->costs[k];
+			}
+			for(k = Loader.Persons.offsets[p]; k < Loader.Persons.offsets[p + 1]; ++k)
+				Loader.Persons.costs[k] -= Presolve->Row_minima[person_i];
+		}
+		
+		//The column minima of the reduced costs, and the edges with them subtracted.
+		for(int o = Presolve->Object_offsets[c]; o < Presolve->Object_offsets[c + 1]; ++o)
+			Presolve->Column_minima[Presolve->Component_objects[o]] = 0;
+		if (reduce_columns)
+		{
+			for(int o = Presolve->Object_offsets[c]; o < Presolve->Object_offsets[c + 1]; ++o)
+				Presolve->Column_minima[Presolve->Component_objects[o]] = _INFINITY;
+			for(k = 0; k < num_edges; ++k)
+			{
+				object_j = Presolve->Component_objects[Presolve->Object_offsets[c] + Loader.Persons.neighbors[k]];
+				if (Loader.Persons.costs[k] < Presolve->Column_minima[object_j]) Presolve->Column_minima[object_j] = Loader.Persons.costs[k];
+			}
+			for(k = 0; k < num_edges; ++k)
+				Loader.Persons.costs[k] -= Presolve->Column_minima[Presolve->Component_objects[Presolve->Object_offsets[c] + Loader.Persons.neighbors[k]]];
+		}
+		
+		Loader.num_persons = component_persons;
+		Loader.num_objects = component_objects;
+		Loader.max_abs_cost = 0;
+		for(k = 0; k < num_edges; ++k)
+		{
+			reduced_cost = (Loader.Persons.costs[k] < 0 ? -Loader.Persons.costs[k] : Loader.Persons.costs[k]);
+			if (reduced_cost > Loader.max_abs_cost) Loader.max_abs_cost = (int)reduced_cost;
+		}
+		Graph_Check_dense(&Loader.Persons, component_objects);
+		snprintf(name, sizeof(name), "%d", c);
+		error = BS_Add_instance(&Presolve->Batch, name, &Loader);
+		if (error.code == -1) strcat(error.msg, " In 'PS_Solve'");
+	}
+	Presolve->presolve_time = Wall_time() - start_time;
+	
+	//Solve the components.
+	if (error.code == 1 && Presolve->num_components > 0)
+	{
+		Presolve->Batch.num_threads = Instance->num_threads;
+		Presolve->Batch.alpha = alpha;
+		AS_Copy_options(&Presolve->Batch.Options, Instance);
+		error = BS_Solve(&Presolve->Batch);
+		if (error.code == -1) strcat(error.msg, " In 'PS_Solve'");
+	}
+	
+	//Map the matching back to the original graph.
+	Instance->Timings.phases_time = Presolve->Batch.solving_time;
+	extraction_time = Wall_time();
+	if (error.code == 1)
+	{
+		error = AS_Reserve_memory(Instance);
+		if (error.code == -1) strcat(error.msg, " In 'PS_Solve'");
+	}
+	if (error.code == 1)
+	{
+		Instance->matching_cost = 0;
+		for(object_j = 0; object_j < num_objects; ++object_j)
+		{
+			Instance->Matching[object_j] = UNMATCHED;
+			Instance->Matching_costs[object_j] = 0;
+			if (Object_mates[object_j] == -1) continue;
+			Instance->Matching[object_j] = Object_mates[object_j];
+			Instance->Matching_costs[object_j] = Presolve->Row_minima[Object_mates[object_j]];
+		}
+		for(c = 0; c < Presolve->num_components; ++c)
+		{
+			Current = &Presolve->Batch.Instances[c];
+			for(int o = 0; o < Presolve->Object_offsets[c + 1] - Presolve->Object_offsets[c]; ++o)
+			{
+				if (Current->Matching[o] == UNMATCHED) continue;
+				object_j = Presolve->Component_objects[Presolve->Object_offsets[c] + o];
+				person_i = Presolve->Component_persons[Presolve->Person_offsets[c] + Current->Matching[o]];
+				Instance->Matching[object_j] = person_i;
+				Instance->Matching_costs[object_j] = Current->Matching_costs[o] + Presolve->Row_minima[person_i] + Presolve->Column_minima[object_j];
+			}
+		}
+		for(object_j = 0; object_j < num_objects; ++object_j) Instance->matching_cost += Instance->Matching_costs[object_j];
+	}
+	
+	free((char*) Person_mates);
+	free((char*) Object_mates);
+	free((char*) Degrees);
+	free((char*) Queue);
+	free((char*) Parents);
+	free((char*) Components);
+	free((char*) Indices);
+	Graph_Clear(&Objects);
+	AS_Clear(&Loader);
+	Instance->is_solved = 0;
+	Presolve->solving_time = Wall_time() - start_time;
+	Instance->solving_time = Presolve->solving_time;
+	//The phases were done by the solvers of the components, 'Instance' has no trace of them.
+	Instance->num_phases = 0;
+	Instance->Timings.presolve_time = Presolve->presolve_time;
+	Instance->Timings.prepare_time = 0;
+	Instance->Timings.extraction_time = Wall_time() - extraction_time;
+	return error;
+}
+
+//*****************************************************************************************
+
+#endif
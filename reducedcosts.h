@@ -0,0 +1,637 @@
+#ifndef _T_REDUCED_COSTS_
+#define _T_REDUCED_COSTS_
+
+#include <string.h>
+#include "types.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define RC_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+//*****************************************************************************************
+// REDUCED COST SCAN KERNELS
+/*
+	Functions that scan the adjacency list of a person and find the smallest and the second smallest
+	reduced costs 'scale * costs[k] - prices[neighbors[k]]'. All of them return the position 'k' (in the
+	adjacency list) of the first neighbor with the smallest reduced cost, and the two values by reference.
+	The second smallest value is taken from the multiset of reduced costs, so it equals the smallest one
+	when two neighbors tie. The vectorized kernels compute the same subtractions and comparisons as the
+	scalar one, so all of them give bit for bit the same results.
+	The 'scale' is only used in integer mode (see "types.h"), where the prices are kept in units of
+	'1 / scale' of a cost. With 'double' costs the reduced costs are 'costs[k] - prices[neighbors[k]]'.
+	If 'neighbors' is NULL the person is adjacent to every object in order, i.e. 'neighbors[k] = k',
+	and the prices are read contiguously instead of gathered.
+	The adjacency list must have at least two neighbors.
+*/
+
+// The available kernels, from the slowest to the fastest.
+#define RC_KERNEL_SCALAR	0
+#define RC_KERNEL_SSE		1
+#define RC_KERNEL_AVX2		2
+#define RC_KERNEL_AVX512	3
+
+// The type of the kernels.
+typedef int (*RC_Scan_function)(const int *neighbors, const costType *costs, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost);
+
+// The reduced cost of the 'k'-th neighbor.
+#ifdef AS_INTEGER_COSTS
+#define RC_REDUCED_COST(neighbors, costs, prices, scale, k) \
+	((priceType)(costs)[k] * (scale) - (prices)[(neighbors) != NULL ? (neighbors)[k] : (k)])
+#else
+#define RC_REDUCED_COST(neighbors, costs, prices, scale, k) \
+	((costs)[k] - (prices)[(neighbors) != NULL ? (neighbors)[k] : (k)])
+#endif
+
+//***********************************
+// SCALAR KERNEL
+
+int		RC_Scan_scalar(const int *neighbors, const costType *costs, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	priceType	best = 0;
+	priceType	second = 0;
+	priceType	auxiliary = 0;
+	int			best_k = 0;
+	
+#ifndef AS_INTEGER_COSTS
+	// The prices are in units of the costs.
+	(void)scale;
+#endif
+	// Find the first two best reduced costs.
+	best = RC_REDUCED_COST(neighbors, costs, prices, scale, 0);
+	auxiliary = RC_REDUCED_COST(neighbors, costs, prices, scale, 1);
+	if (best <= auxiliary) second = auxiliary;
+	else
+	{
+		second = best;
+		best = auxiliary;
+		best_k = 1;
+	}
+	
+	//Scan the rest of neighbours.
+	for(int k = 2; k < num_neighbors; ++k)
+	{
+		auxiliary = RC_REDUCED_COST(neighbors, costs, prices, scale, k);
+		
+		//Update the smallest and second smallest reduced costs.
+		if(auxiliary < best)
+		{
+			second = best;
+			best = auxiliary;
+			best_k = k;
+		}
+		else if(auxiliary < second)
+			second = auxiliary;
+	}
+	
+	*best_reduced_cost = best;
+	*second_best_reduced_cost = second;
+	return best_k;
+}
+
+// Merge the partial results of the lanes of a vectorized kernel, and scan with the scalar code the
+// neighbors from 'first_k' on that did not fill a whole vector.
+// Lane 'l' has the smallest value 'lane_best[l]' at position 'lane_best_k[l]' and the second smallest 'lane_second[l]'.
+int		RC_Merge_lanes(const priceType *lane_best, const priceType *lane_second, const priceType *lane_best_k, int num_lanes,
+	const int *neighbors, const costType *costs, const priceType *prices, priceType scale, int first_k, int num_neighbors,
+	priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	priceType	best = lane_best[0];
+	priceType	second = 0;
+	priceType	auxiliary = 0;
+	int			best_lane = 0;
+	int			best_k = 0;
+	
+#ifndef AS_INTEGER_COSTS
+	(void)scale;
+#endif
+	
+	// The smallest value of all lanes, the ties are broken by the smallest position.
+	for(int l = 1; l < num_lanes; ++l)
+		if (lane_best[l] < best || (lane_best[l] == best && lane_best_k[l] < lane_best_k[best_lane]))
+		{
+			best = lane_best[l];
+			best_lane = l;
+		}
+	best_k = (int) lane_best_k[best_lane];
+	// The second smallest is the smallest among the rest of the lanes and the second of the best lane.
+	second = lane_second[best_lane];
+	for(int l = 0; l < num_lanes; ++l)
+	{
+		if (l != best_lane && lane_best[l] < second) second = lane_best[l];
+		if (lane_second[l] < second) second = lane_second[l];
+	}
+	
+	// The remaining neighbors are after all the previous ones, so a tie does not change the best position.
+	for(int k = first_k; k < num_neighbors; ++k)
+	{
+		auxiliary = RC_REDUCED_COST(neighbors, costs, prices, scale, k);
+		if(auxiliary < best)
+		{
+			second = best;
+			best = auxiliary;
+			best_k = k;
+		}
+		else if(auxiliary < second)
+			second = auxiliary;
+	}
+	
+	*best_reduced_cost = best;
+	*second_best_reduced_cost = second;
+	return best_k;
+}
+
+#ifdef RC_X86_KERNELS
+#ifdef AS_INTEGER_COSTS
+
+// Initial value of the lanes of the integer kernels, larger than any reduced cost.
+#define RC_INTEGER_INFINITY	0x7FFFFFFFFFFFFFFFLL
+
+//***********************************
+// SSE KERNEL (2 lanes, the prices are loaded one by one since there are no gathers)
+
+__attribute__((target("sse4.2")))
+int		RC_Scan_sse(const int *neighbors, const costType *costs, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	__m128i		best = _mm_set1_epi64x(RC_INTEGER_INFINITY);
+	__m128i		second = _mm_set1_epi64x(RC_INTEGER_INFINITY);
+	__m128i		best_k = _mm_setzero_si128();
+	__m128i		position = _mm_set_epi64x(1, 0);
+	__m128i		step = _mm_set1_epi64x(2);
+	__m128i		scale_vector = _mm_set1_epi64x(scale);
+	__m128i		reduced_cost, is_better, price;
+	priceType	lane_best[2], lane_second[2], lane_best_k[2];
+	int			k = 0;
+	
+	for(; k + 2 <= num_neighbors; k += 2)
+	{
+		if (neighbors != NULL) price = _mm_set_epi64x(prices[neighbors[k + 1]], prices[neighbors[k]]);
+		else price = _mm_loadu_si128((const __m128i*)(prices + k));
+		reduced_cost = _mm_sub_epi64(_mm_mul_epi32(_mm_cvtepi32_epi64(_mm_loadl_epi64((const __m128i*)(costs + k))), scale_vector), price);
+		is_better = _mm_cmpgt_epi64(best, reduced_cost);
+		second = _mm_blendv_epi8(_mm_blendv_epi8(second, reduced_cost, _mm_cmpgt_epi64(second, reduced_cost)), best, is_better);
+		best = _mm_blendv_epi8(best, reduced_cost, is_better);
+		best_k = _mm_blendv_epi8(best_k, position, is_better);
+		position = _mm_add_epi64(position, step);
+	}
+	_mm_storeu_si128((__m128i*)lane_best, best);
+	_mm_storeu_si128((__m128i*)lane_second, second);
+	_mm_storeu_si128((__m128i*)lane_best_k, best_k);
+	
+	return RC_Merge_lanes(lane_best, lane_second, lane_best_k, 2, neighbors, costs, prices, scale, k, num_neighbors,
+		best_reduced_cost, second_best_reduced_cost);
+}
+
+//***********************************
+// AVX2 KERNEL (4 lanes, the prices are gathered)
+
+__attribute__((target("avx2")))
+int		RC_Scan_avx2(const int *neighbors, const costType *costs, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	__m256i		best = _mm256_set1_epi64x(RC_INTEGER_INFINITY);
+	__m256i		second = _mm256_set1_epi64x(RC_INTEGER_INFINITY);
+	__m256i		best_k = _mm256_setzero_si256();
+	__m256i		position = _mm256_set_epi64x(3, 2, 1, 0);
+	__m256i		step = _mm256_set1_epi64x(4);
+	__m256i		scale_vector = _mm256_set1_epi64x(scale);
+	__m256i		reduced_cost, is_better, price;
+	priceType	lane_best[4], lane_second[4], lane_best_k[4];
+	int			k = 0;
+	
+	for(; k + 4 <= num_neighbors; k += 4)
+	{
+		if (neighbors != NULL) price = _mm256_i32gather_epi64(prices, _mm_loadu_si128((const __m128i*)(neighbors + k)), 8);
+		else price = _mm256_loadu_si256((const __m256i*)(prices + k));
+		reduced_cost = _mm256_sub_epi64(_mm256_mul_epi32(_mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(costs + k))), scale_vector), price);
+		is_better = _mm256_cmpgt_epi64(best, reduced_cost);
+		second = _mm256_blendv_epi8(_mm256_blendv_epi8(second, reduced_cost, _mm256_cmpgt_epi64(second, reduced_cost)), best, is_better);
+		best = _mm256_blendv_epi8(best, reduced_cost, is_better);
+		best_k = _mm256_blendv_epi8(best_k, position, is_better);
+		position = _mm256_add_epi64(position, step);
+	}
+	_mm256_storeu_si256((__m256i*)lane_best, best);
+	_mm256_storeu_si256((__m256i*)lane_second, second);
+	_mm256_storeu_si256((__m256i*)lane_best_k, best_k);
+	
+	return RC_Merge_lanes(lane_best, lane_second, lane_best_k, 4, neighbors, costs, prices, scale, k, num_neighbors,
+		best_reduced_cost, second_best_reduced_cost);
+}
+
+//***********************************
+// AVX-512 KERNEL (8 lanes, the prices are gathered)
+
+__attribute__((target("avx512f")))
+int		RC_Scan_avx512(const int *neighbors, const costType *costs, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	__m512i		best = _mm512_set1_epi64(RC_INTEGER_INFINITY);
+	__m512i		second = _mm512_set1_epi64(RC_INTEGER_INFINITY);
+	__m512i		best_k = _mm512_setzero_si512();
+	__m512i		position = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+	__m512i		step = _mm512_set1_epi64(8);
+	__m512i		scale_vector = _mm512_set1_epi64(scale);
+	__m512i		reduced_cost, price;
+	__mmask8	is_better;
+	priceType	lane_best[8], lane_second[8], lane_best_k[8];
+	int			k = 0;
+	
+	for(; k + 8 <= num_neighbors; k += 8)
+	{
+		if (neighbors != NULL) price = _mm512_i32gather_epi64(_mm256_loadu_si256((const __m256i*)(neighbors + k)), prices, 8);
+		else price = _mm512_loadu_si512(prices + k);
+		reduced_cost = _mm512_sub_epi64(_mm512_mul_epi32(_mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i*)(costs + k))), scale_vector), price);
+		is_better = _mm512_cmplt_epi64_mask(reduced_cost, best);
+		second = _mm512_mask_blend_epi64(is_better, _mm512_min_epi64(second, reduced_cost), best);
+		best = _mm512_mask_blend_epi64(is_better, best, reduced_cost);
+		best_k = _mm512_mask_blend_epi64(is_better, best_k, position);
+		position = _mm512_add_epi64(position, step);
+	}
+	_mm512_storeu_si512(lane_best, best);
+	_mm512_storeu_si512(lane_second, second);
+	_mm512_storeu_si512(lane_best_k, best_k);
+	
+	return RC_Merge_lanes(lane_best, lane_second, lane_best_k, 8, neighbors, costs, prices, scale, k, num_neighbors,
+		best_reduced_cost, second_best_reduced_cost);
+}
+
+#else
+
+
+//***********************************
+// SSE KERNEL (2 lanes, the prices are loaded one by one since there are no gathers)
+
+__attribute__((target("sse2")))
+int		RC_Scan_sse(const int *neighbors, const costType *costs, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	__m128d		best = _mm_set1_pd(__builtin_inf());
+	__m128d		second = _mm_set1_pd(__builtin_inf());
+	__m128d		best_k = _mm_setzero_pd();
+	__m128d		position = _mm_set_pd(1.0, 0.0);
+	__m128d		step = _mm_set1_pd(2.0);
+	__m128d		reduced_cost, is_better, price;
+	double		lane_best[2], lane_second[2], lane_best_k[2];
+	int			k = 0;
+	
+	for(; k + 2 <= num_neighbors; k += 2)
+	{
+		if (neighbors != NULL) price = _mm_set_pd(prices[neighbors[k + 1]], prices[neighbors[k]]);
+		else price = _mm_loadu_pd(prices + k);
+		reduced_cost = _mm_sub_pd(_mm_loadu_pd(costs + k), price);
+		is_better = _mm_cmplt_pd(reduced_cost, best);
+		// second = is_better ? best : min(second, reduced_cost)
+		second = _mm_or_pd(_mm_and_pd(is_better, best), _mm_andnot_pd(is_better, _mm_min_pd(second, reduced_cost)));
+		best = _mm_or_pd(_mm_and_pd(is_better, reduced_cost), _mm_andnot_pd(is_better, best));
+		best_k = _mm_or_pd(_mm_and_pd(is_better, position), _mm_andnot_pd(is_better, best_k));
+		position = _mm_add_pd(position, step);
+	}
+	_mm_storeu_pd(lane_best, best);
+	_mm_storeu_pd(lane_second, second);
+	_mm_storeu_pd(lane_best_k, best_k);
+	
+	return RC_Merge_lanes(lane_best, lane_second, lane_best_k, 2, neighbors, costs, prices, scale, k, num_neighbors,
+		best_reduced_cost, second_best_reduced_cost);
+}
+
+//***********************************
+// AVX2 KERNEL (4 lanes, the prices are gathered)
+
+__attribute__((target("avx2")))
+int		RC_Scan_avx2(const int *neighbors, const costType *costs, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	__m256d		best = _mm256_set1_pd(__builtin_inf());
+	__m256d		second = _mm256_set1_pd(__builtin_inf());
+	__m256d		best_k = _mm256_setzero_pd();
+	__m256d		position = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+	__m256d		step = _mm256_set1_pd(4.0);
+	__m256d		reduced_cost, is_better, price;
+	double		lane_best[4], lane_second[4], lane_best_k[4];
+	int			k = 0;
+	
+	for(; k + 4 <= num_neighbors; k += 4)
+	{
+		if (neighbors != NULL) price = _mm256_i32gather_pd(prices, _mm_loadu_si128((const __m128i*)(neighbors + k)), 8);
+		else price = _mm256_loadu_pd(prices + k);
+		reduced_cost = _mm256_sub_pd(_mm256_loadu_pd(costs + k), price);
+		is_better = _mm256_cmp_pd(reduced_cost, best, _CMP_LT_OQ);
+		second = _mm256_blendv_pd(_mm256_min_pd(second, reduced_cost), best, is_better);
+		best = _mm256_blendv_pd(best, reduced_cost, is_better);
+		best_k = _mm256_blendv_pd(best_k, position, is_better);
+		position = _mm256_add_pd(position, step);
+	}
+	_mm256_storeu_pd(lane_best, best);
+	_mm256_storeu_pd(lane_second, second);
+	_mm256_storeu_pd(lane_best_k, best_k);
+	
+	return RC_Merge_lanes(lane_best, lane_second, lane_best_k, 4, neighbors, costs, prices, scale, k, num_neighbors,
+		best_reduced_cost, second_best_reduced_cost);
+}
+
+//***********************************
+// AVX-512 KERNEL (8 lanes, the prices are gathered)
+
+__attribute__((target("avx512f")))
+int		RC_Scan_avx512(const int *neighbors, const costType *costs, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	__m512d		best = _mm512_set1_pd(__builtin_inf());
+	__m512d		second = _mm512_set1_pd(__builtin_inf());
+	__m512d		best_k = _mm512_setzero_pd();
+	__m512d		position = _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0);
+	__m512d		step = _mm512_set1_pd(8.0);
+	__m512d		reduced_cost, price;
+	__mmask8	is_better;
+	double		lane_best[8], lane_second[8], lane_best_k[8];
+	int			k = 0;
+	
+	for(; k + 8 <= num_neighbors; k += 8)
+	{
+		if (neighbors != NULL) price = _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i*)(neighbors + k)), prices, 8);
+		else price = _mm512_loadu_pd(prices + k);
+		reduced_cost = _mm512_sub_pd(_mm512_loadu_pd(costs + k), price);
+		is_better = _mm512_cmp_pd_mask(reduced_cost, best, _CMP_LT_OQ);
+		second = _mm512_mask_blend_pd(is_better, _mm512_min_pd(second, reduced_cost), best);
+		best = _mm512_mask_blend_pd(is_better, best, reduced_cost);
+		best_k = _mm512_mask_blend_pd(is_better, best_k, position);
+		position = _mm512_add_pd(position, step);
+	}
+	_mm512_storeu_pd(lane_best, best);
+	_mm512_storeu_pd(lane_second, second);
+	_mm512_storeu_pd(lane_best_k, best_k);
+	
+	return RC_Merge_lanes(lane_best, lane_second, lane_best_k, 8, neighbors, costs, prices, scale, k, num_neighbors,
+		best_reduced_cost, second_best_reduced_cost);
+}
+
+#endif
+#endif
+
+#ifdef AS_INTEGER_COSTS
+
+//***********************************
+// PACKED EDGES KERNELS
+/*
+	In integer mode an edge can also be stored as a single 64 bits word with the neighbor in the low 32 bits and the
+	cost in the high 32 bits (see 'packed_edges' in "AP_Tools.h"), so that the scan reads one stream of edges instead
+	of the two arrays 'neighbors' and 'costs'. These kernels are the versions of the ones above for such a list of
+	edges, and give the same results.
+*/
+
+// A packed edge, and the macros to build it and to get its neighbor and its cost.
+typedef unsigned long long	RC_Packed_edge;
+#define RC_PACK_EDGE(neighbor, cost)	((RC_Packed_edge)(unsigned int)(neighbor) | ((RC_Packed_edge)(unsigned int)(cost) << 32))
+#define RC_PACKED_NEIGHBOR(edge)		((int)(unsigned int)(edge))
+#define RC_PACKED_COST(edge)			((costType)(int)(unsigned int)((edge) >> 32))
+
+// The type of the packed edges kernels.
+typedef int (*RC_Scan_packed_function)(const RC_Packed_edge *edges, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost);
+
+// The reduced cost of the 'k'-th packed edge.
+#define RC_PACKED_REDUCED_COST(edges, prices, scale, k) \
+	((priceType)RC_PACKED_COST((edges)[k]) * (scale) - (prices)[RC_PACKED_NEIGHBOR((edges)[k])])
+
+int		RC_Scan_packed_scalar(const RC_Packed_edge *edges, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	priceType	best = RC_PACKED_REDUCED_COST(edges, prices, scale, 0);
+	priceType	second = RC_PACKED_REDUCED_COST(edges, prices, scale, 1);
+	priceType	auxiliary = 0;
+	int			best_k = 0;
+	
+	if (second < best)
+	{
+		auxiliary = best;
+		best = second;
+		second = auxiliary;
+		best_k = 1;
+	}
+	for(int k = 2; k < num_neighbors; ++k)
+	{
+		auxiliary = RC_PACKED_REDUCED_COST(edges, prices, scale, k);
+		if(auxiliary < best)
+		{
+			second = best;
+			best = auxiliary;
+			best_k = k;
+		}
+		else if(auxiliary < second)
+			second = auxiliary;
+	}
+	
+	*best_reduced_cost = best;
+	*second_best_reduced_cost = second;
+	return best_k;
+}
+
+#ifdef RC_X86_KERNELS
+
+// Version of 'RC_Merge_lanes' for the packed edges kernels: merge the lanes and scan the edges from 'first_k' on.
+int		RC_Merge_lanes_packed(const priceType *lane_best, const priceType *lane_second, const priceType *lane_best_k,
+	int num_lanes, const RC_Packed_edge *edges, const priceType *prices, priceType scale, int first_k, int num_neighbors,
+	priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	priceType	auxiliary = 0;
+	int			best_k = RC_Merge_lanes(lane_best, lane_second, lane_best_k, num_lanes, NULL, NULL, prices, scale,
+		num_neighbors, num_neighbors, best_reduced_cost, second_best_reduced_cost);
+	
+	for(int k = first_k; k < num_neighbors; ++k)
+	{
+		auxiliary = RC_PACKED_REDUCED_COST(edges, prices, scale, k);
+		if(auxiliary < *best_reduced_cost)
+		{
+			*second_best_reduced_cost = *best_reduced_cost;
+			*best_reduced_cost = auxiliary;
+			best_k = k;
+		}
+		else if(auxiliary < *second_best_reduced_cost)
+			*second_best_reduced_cost = auxiliary;
+	}
+	return best_k;
+}
+
+// The vectorized kernels take the costs from the high halves of the edges, since '_mm*_mul_epi32' only reads the
+// low 32 bits (with sign) of each 64 bits lane.
+
+__attribute__((target("sse4.2")))
+int		RC_Scan_packed_sse(const RC_Packed_edge *edges, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	__m128i		best = _mm_set1_epi64x(RC_INTEGER_INFINITY);
+	__m128i		second = _mm_set1_epi64x(RC_INTEGER_INFINITY);
+	__m128i		best_k = _mm_setzero_si128();
+	__m128i		position = _mm_set_epi64x(1, 0);
+	__m128i		step = _mm_set1_epi64x(2);
+	__m128i		scale_vector = _mm_set1_epi64x(scale);
+	__m128i		reduced_cost, is_better, price;
+	priceType	lane_best[2], lane_second[2], lane_best_k[2];
+	int			k = 0;
+	
+	for(; k + 2 <= num_neighbors; k += 2)
+	{
+		price = _mm_set_epi64x(prices[RC_PACKED_NEIGHBOR(edges[k + 1])], prices[RC_PACKED_NEIGHBOR(edges[k])]);
+		reduced_cost = _mm_sub_epi64(_mm_mul_epi32(_mm_srli_epi64(_mm_loadu_si128((const __m128i*)(edges + k)), 32), scale_vector), price);
+		is_better = _mm_cmpgt_epi64(best, reduced_cost);
+		second = _mm_blendv_epi8(_mm_blendv_epi8(second, reduced_cost, _mm_cmpgt_epi64(second, reduced_cost)), best, is_better);
+		best = _mm_blendv_epi8(best, reduced_cost, is_better);
+		best_k = _mm_blendv_epi8(best_k, position, is_better);
+		position = _mm_add_epi64(position, step);
+	}
+	_mm_storeu_si128((__m128i*)lane_best, best);
+	_mm_storeu_si128((__m128i*)lane_second, second);
+	_mm_storeu_si128((__m128i*)lane_best_k, best_k);
+	
+	return RC_Merge_lanes_packed(lane_best, lane_second, lane_best_k, 2, edges, prices, scale, k, num_neighbors,
+		best_reduced_cost, second_best_reduced_cost);
+}
+
+__attribute__((target("avx2")))
+int		RC_Scan_packed_avx2(const RC_Packed_edge *edges, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	__m256i		best = _mm256_set1_epi64x(RC_INTEGER_INFINITY);
+	__m256i		second = _mm256_set1_epi64x(RC_INTEGER_INFINITY);
+	__m256i		best_k = _mm256_setzero_si256();
+	__m256i		position = _mm256_set_epi64x(3, 2, 1, 0);
+	__m256i		step = _mm256_set1_epi64x(4);
+	__m256i		scale_vector = _mm256_set1_epi64x(scale);
+	// Moves the low halves of the edges (the neighbors) to the low 128 bits.
+	__m256i		low_halves = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+	__m256i		packed, reduced_cost, is_better, price;
+	priceType	lane_best[4], lane_second[4], lane_best_k[4];
+	int			k = 0;
+	
+	for(; k + 4 <= num_neighbors; k += 4)
+	{
+		packed = _mm256_loadu_si256((const __m256i*)(edges + k));
+		price = _mm256_i32gather_epi64(prices, _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(packed, low_halves)), 8);
+		reduced_cost = _mm256_sub_epi64(_mm256_mul_epi32(_mm256_srli_epi64(packed, 32), scale_vector), price);
+		is_better = _mm256_cmpgt_epi64(best, reduced_cost);
+		second = _mm256_blendv_epi8(_mm256_blendv_epi8(second, reduced_cost, _mm256_cmpgt_epi64(second, reduced_cost)), best, is_better);
+		best = _mm256_blendv_epi8(best, reduced_cost, is_better);
+		best_k = _mm256_blendv_epi8(best_k, position, is_better);
+		position = _mm256_add_epi64(position, step);
+	}
+	_mm256_storeu_si256((__m256i*)lane_best, best);
+	_mm256_storeu_si256((__m256i*)lane_second, second);
+	_mm256_storeu_si256((__m256i*)lane_best_k, best_k);
+	
+	return RC_Merge_lanes_packed(lane_best, lane_second, lane_best_k, 4, edges, prices, scale, k, num_neighbors,
+		best_reduced_cost, second_best_reduced_cost);
+}
+
+__attribute__((target("avx512f")))
+int		RC_Scan_packed_avx512(const RC_Packed_edge *edges, const priceType *prices, priceType scale,
+	int num_neighbors, priceType *best_reduced_cost, priceType *second_best_reduced_cost)
+{
+	__m512i		best = _mm512_set1_epi64(RC_INTEGER_INFINITY);
+	__m512i		second = _mm512_set1_epi64(RC_INTEGER_INFINITY);
+	__m512i		best_k = _mm512_setzero_si512();
+	__m512i		position = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+	__m512i		step = _mm512_set1_epi64(8);
+	__m512i		scale_vector = _mm512_set1_epi64(scale);
+	__m512i		packed, reduced_cost, price;
+	__mmask8	is_better;
+	priceType	lane_best[8], lane_second[8], lane_best_k[8];
+	int			k = 0;
+	
+	for(; k + 8 <= num_neighbors; k += 8)
+	{
+		packed = _mm512_loadu_si512(edges + k);
+		price = _mm512_i32gather_epi64(_mm512_cvtepi64_epi32(packed), prices, 8);
+		reduced_cost = _mm512_sub_epi64(_mm512_mul_epi32(_mm512_srli_epi64(packed, 32), scale_vector), price);
+		is_better = _mm512_cmplt_epi64_mask(reduced_cost, best);
+		second = _mm512_mask_blend_epi64(is_better, _mm512_min_epi64(second, reduced_cost), best);
+		best = _mm512_mask_blend_epi64(is_better, best, reduced_cost);
+		best_k = _mm512_mask_blend_epi64(is_better, best_k, position);
+		position = _mm512_add_epi64(position, step);
+	}
+	_mm512_storeu_si512(lane_best, best);
+	_mm512_storeu_si512(lane_second, second);
+	_mm512_storeu_si512(lane_best_k, best_k);
+	
+	return RC_Merge_lanes_packed(lane_best, lane_second, lane_best_k, 8, edges, prices, scale, k, num_neighbors,
+		best_reduced_cost, second_best_reduced_cost);
+}
+
+#endif
+#endif
+
+//***********************************
+// KERNEL SELECTION
+
+// Get the fastest kernel supported by the CPU, but not faster than 'max_kernel' (one of the 'RC_KERNEL_*' values).
+// The chosen kernel is returned, and its 'RC_KERNEL_*' value is returned by reference in 'kernel'.
+RC_Scan_function	RC_Select_kernel(int max_kernel, int *kernel)
+{
+#ifdef RC_X86_KERNELS
+	__builtin_cpu_init();
+	if (max_kernel >= RC_KERNEL_AVX512 && __builtin_cpu_supports("avx512f"))
+	{
+		*kernel = RC_KERNEL_AVX512;
+		return RC_Scan_avx512;
+	}
+	if (max_kernel >= RC_KERNEL_AVX2 && __builtin_cpu_supports("avx2"))
+	{
+		*kernel = RC_KERNEL_AVX2;
+		return RC_Scan_avx2;
+	}
+	// The integer SSE kernel needs the 64 bits comparisons of SSE4.2.
+#ifdef AS_INTEGER_COSTS
+	if (max_kernel >= RC_KERNEL_SSE && __builtin_cpu_supports("sse4.2"))
+#else
+	if (max_kernel >= RC_KERNEL_SSE && __builtin_cpu_supports("sse2"))
+#endif
+	{
+		*kernel = RC_KERNEL_SSE;
+		return RC_Scan_sse;
+	}
+#endif
+	*kernel = RC_KERNEL_SCALAR;
+	return RC_Scan_scalar;
+}
+
+#ifdef AS_INTEGER_COSTS
+// The packed edges version of the kernel 'kernel' (one of the 'RC_KERNEL_*' values, as chosen by 'RC_Select_kernel').
+RC_Scan_packed_function	RC_Packed_kernel(int kernel)
+{
+#ifdef RC_X86_KERNELS
+	switch (kernel)
+	{
+		case RC_KERNEL_SSE: return RC_Scan_packed_sse;
+		case RC_KERNEL_AVX2: return RC_Scan_packed_avx2;
+		case RC_KERNEL_AVX512: return RC_Scan_packed_avx512;
+	}
+#endif
+	return RC_Scan_packed_scalar;
+}
+#endif
+
+// Name of a kernel, for reporting.
+const char	*RC_Kernel_name(int kernel)
+{
+	switch (kernel)
+	{
+		case RC_KERNEL_SSE: return "sse";
+		case RC_KERNEL_AVX2: return "avx2";
+		case RC_KERNEL_AVX512: return "avx512";
+		default: return "scalar";
+	}
+}
+
+// The 'RC_KERNEL_*' value of a kernel given its name, or '-1' if there is no kernel with that name.
+int		RC_Kernel_from_name(const char *name)
+{
+	for (int kernel = RC_KERNEL_SCALAR; kernel <= RC_KERNEL_AVX512; ++kernel)
+		if (strcmp(name, RC_Kernel_name(kernel)) == 0) return kernel;
+	return -1;
+}
+
+//*****************************************************************************************
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef _T_THREAD_POOL_
+#define _T_THREAD_POOL_
+
+#include <pthread.h>
+#include "error.h"
+
+//*****************************************************************************************
+// THREADPOOL STRUCTURE
+/*
+	Structure that keeps a fixed set of worker threads waiting on a barrier, so that the same
+	task can be run by all of them many times without creating threads each time.
+	The thread that calls 'TP_Run' takes part as the thread with index '0', so a pool of 'num_threads'
+	threads only creates 'num_threads - 1' workers. A pool of one thread runs the task directly.
+*/
+typedef struct
+{
+	// The number of threads that run each task, including the calling thread.
+	int					num_threads;
+	// The worker threads (there are 'num_threads - 1' of them).
+	pthread_t			*workers;
+	// The barriers used to start a task and to wait for all threads to finish it.
+	pthread_barrier_t	start_barrier;
+	pthread_barrier_t	end_barrier;
+	// Held while the workers are being created, so that they do not use the barriers before they exist.
+	pthread_mutex_t		create_lock;
+	// The current task and its argument. Each thread calls 'task(arg, thread_i, num_threads)'.
+	void				(*task)(void *arg, int thread_i, int num_threads);
+	void				*arg;
+	// Set to '1' to make the workers exit.
+	int					stop;
+} ThreadPool;
+
+// Argument of each worker thread: the pool and the index of the thread in it.
+typedef struct
+{
+	ThreadPool	*pool;
+	int			thread_i;
+} TP_Worker_arg;
+
+//***********************************
+// THREADPOOL METHODS
+
+// Constructor: initializes the members to safe default values.
+// This function always needs to be called on a 'ThreadPool' instance before any other move.
+void	TP_Defaults(ThreadPool *TP)
+{
+	TP->num_threads = 1;
+	TP->workers = NULL;
+	TP->task = NULL;
+	TP->arg = NULL;
+	TP->stop = 0;
+}
+
+// Main loop of the worker threads: wait for a task, run it and report that it is done.
+void	*TP_Worker_loop(void *worker_arg)
+{
+	ThreadPool	*TP = ((TP_Worker_arg*) worker_arg)->pool;
+	int			thread_i = ((TP_Worker_arg*) worker_arg)->thread_i;
+	
+	free(worker_arg);
+	// Wait until all the workers were created. If some could not be created the pool keeps one thread
+	// and the workers exit without touching the barriers.
+	pthread_mutex_lock(&TP->create_lock);
+	pthread_mutex_unlock(&TP->create_lock);
+	if (TP->num_threads == 1) return NULL;
+	while(1)
+	{
+		pthread_barrier_wait(&TP->start_barrier);
+		if (TP->stop) break;
+		TP->task(TP->arg, thread_i, TP->num_threads);
+		pthread_barrier_wait(&TP->end_barrier);
+	}
+	return NULL;
+}
+
+// Safe destructor: stop and join the worker threads and set everything to default values.
+void	TP_Clear(ThreadPool *TP)
+{
+	if (TP->workers != NULL)
+	{
+		TP->stop = 1;
+		pthread_barrier_wait(&TP->start_barrier);
+		for (int thread_i = 1; thread_i < TP->num_threads; ++thread_i)
+			pthread_join(TP->workers[thread_i - 1], NULL);
+		pthread_barrier_destroy(&TP->start_barrier);
+		pthread_barrier_destroy(&TP->end_barrier);
+		pthread_mutex_destroy(&TP->create_lock);
+		free((char*) TP->workers);
+	}
+	TP_Defaults(TP);
+}
+
+// Create the worker threads so that tasks are run by 'num_threads' threads.
+// If the pool already has that number of threads nothing is done.
+// In case of error, an Error instance will be returned and the pool will run tasks on the calling thread only.
+Error	TP_Create(ThreadPool *TP, int num_threads)
+{
+	Error			error = {1, "OK"};
+	TP_Worker_arg	*worker_arg;
+	
+	if (num_threads == TP->num_threads) return error;
+	TP_Clear(TP);
+	if (num_threads <= 1) return error;
+	
+	TP->workers = (pthread_t*) malloc((num_threads - 1) * sizeof(pthread_t));
+	if (TP->workers == NULL)
+	{
+		Error_Set(&error, -1, "Error: no memory for the allocation of the threads in 'TP_Create'");
+		return error;
+	}
+	pthread_mutex_init(&TP->create_lock, NULL);
+	pthread_mutex_lock(&TP->create_lock);
+	
+	for (int thread_i = 1; thread_i < num_threads; ++thread_i)
+	{
+		worker_arg = (TP_Worker_arg*) malloc(sizeof(TP_Worker_arg));
+		if (worker_arg != NULL)
+		{
+			worker_arg->pool = TP;
+			worker_arg->thread_i = thread_i;
+		}
+		if (worker_arg == NULL || pthread_create(&TP->workers[thread_i - 1], NULL, TP_Worker_loop, worker_arg) != 0)
+		{
+			// Let the threads already created exit, they have not touched the barriers yet.
+			free(worker_arg);
+			pthread_mutex_unlock(&TP->create_lock);
+			for (int created_i = 1; created_i < thread_i; ++created_i)
+				pthread_join(TP->workers[created_i - 1], NULL);
+			pthread_mutex_destroy(&TP->create_lock);
+			free((char*) TP->workers);
+			TP_Defaults(TP);
+			Error_Set(&error, -1, "Error: the threads could not be created in 'TP_Create'");
+			return error;
+		}
+	}
+	
+	pthread_barrier_init(&TP->start_barrier, NULL, num_threads);
+	pthread_barrier_init(&TP->end_barrier, NULL, num_threads);
+	TP->num_threads = num_threads;
+	pthread_mutex_unlock(&TP->create_lock);
+	
+	return error;
+}
+
+// Run 'task(arg, thread_i, num_threads)' on every thread of the pool (the calling thread is 'thread_i = 0')
+// and wait until all of them are done.
+void	TP_Run(ThreadPool *TP, void (*task)(void *arg, int thread_i, int num_threads), void *arg)
+{
+	if (TP->workers == NULL)
+	{
+		task(arg, 0, 1);
+		return;
+	}
+	TP->task = task;
+	TP->arg = arg;
+	pthread_barrier_wait(&TP->start_barrier);
+	task(arg, 0, TP->num_threads);
+	pthread_barrier_wait(&TP->end_barrier);
+}
+
+//*****************************************************************************************
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <float.h>
+#include <sys/mman.h>
 #include "error.h"
 
 //*****************************************************************************************
@@ -12,109 +14,400 @@
 const int UNMATCHED = 2147483647;
 // A big number.
 const double _INFINITY = 1000000000.0;
+
+// Compiling with 'AS_INTEGER_COSTS' defined (e.g. 'gcc -DAS_INTEGER_COSTS') selects the integer mode: the edge
+// costs are stored as 32 bits integers and the prices as 64 bits integers. Since the costs are integers,
+// the solver multiplies them by 'num_persons + 1' so that every epsilon, down to the final one, is an integer
+// (Bertsekas' integer auction), and the whole algorithm is exact.
+// Without it the costs and the prices are 'double'.
+#ifdef AS_INTEGER_COSTS
+// The type for the edge costs.
+typedef int			costType;
+// The type for the prices, and for any value derived from them (reduced costs, epsilon).
+typedef long long	priceType;
+#else
 // The type for the edge costs.
-typedef double	costType;
+typedef double		costType;
+// The type for the prices, and for any value derived from them (reduced costs, epsilon).
+typedef double		priceType;
+#endif
+
+// The reduced cost of an option that does not exist, such as the best real object of a person without neighbors.
+// It is bigger than any reduced cost, unlike '_INFINITY', which the prices of the integer mode can go far beyond.
+#ifdef AS_INTEGER_COSTS
+const priceType NO_OPTION = 0x7FFFFFFFFFFFFFFFLL;
+#else
+const priceType NO_OPTION = DBL_MAX;
+#endif
 
 //*****************************************************************************************
-// PERSON STRUCTURE
+// GRAPH STRUCTURE
 /*
-	Structure that contains the necessary information of a Person Vertex.
-	This information is the number of neighbors that the person has, 
-	an array for the indices of the neighbors, and an array for the edge
-	costs of the person with its neighbors in the same order.
+	Since the Auction algorithm only works with the adjacency lists of the Persons,
+	then we will only store such adjacency lists. They are stored in Compressed Sparse Row
+	(CSR) format: the adjacency lists of all the persons are placed one after the other in
+	a single 'neighbors' array and a single 'costs' array, and the array 'offsets' tells
+	where the adjacency list of each person begins.
+	The adjacency list of person 'i' is stored in the positions {offsets[i], ..., offsets[i + 1] - 1}
+	of the arrays 'neighbors' and 'costs', so its number of neighbors is 'offsets[i + 1] - offsets[i]'.
+	This way the whole graph lives in three memory blocks, instead of two blocks per person.
+	The three arrays can also point inside a file mapped into memory (see 'AS_Load_graph_Wbg2'), in which
+	case the graph owns the mapping instead of the arrays.
+	A dense graph (every person adjacent to all the objects) does not store the 'neighbors' array, which
+	is NULL: the costs are a row-major matrix and the neighbor in the position 'k' of the adjacency list of
+	person 'i' is the object 'k - offsets[i]' (see 'Graph_Neighbor').
 */
 typedef struct
 {
-	// Number of neighbors of the person.
-	int			num_neighbors;
+	// Number of persons of the graph.
+	int			num_persons;
+	// Total number of edges of the graph, i.e. the length of the arrays 'neighbors' and 'costs'.
+	int			num_edges;
+	// Array of 'num_persons + 1' elements with the beginning of each adjacency list.
+	// The last element is always 'num_edges'.
+	int			*offsets;
 	// Array of neighbors indices (the indices are in the range {0, ... , num_objects - 1}.
+	// NULL in dense graphs.
 	int			*neighbors;
 	// Array of edge costs with the neighbors, in the same order as the 'neighbors' array.
-	// i.e. this person has an edge with object neighbor[i] with cost costs[i].
+	// i.e. there is an edge with object neighbors[k] with cost costs[k].
 	costType	*costs;
-} Person;
+	// '1' if every person is adjacent to all the objects in increasing order, i.e. 'neighbors[offsets[i] + k] = k'.
+	// Set by 'Graph_Check_dense' and 'Graph_Allocate_dense', and then 'neighbors' is NULL.
+	int			is_dense;
+	// If not NULL, the arrays are inside this memory mapping of 'mapped_size' bytes, which is unmapped by 'Graph_Clear'.
+	void		*mapped_base;
+	long int	mapped_size;
+	// The number of persons and of edges that fit in the allocated arrays (see 'Graph_Allocate').
+	int			persons_capacity;
+	int			edges_capacity;
+} Graph;
 
 //***********************************
-// PERSON METHODS
+// GRAPH METHODS
+
+// Constructor: initializes the members to safe default values.
+// This function always needs to be called on a 'Graph' instance before any other move.
+void	Graph_Defaults(Graph *G)
+{
+	G->num_persons = 0;
+	G->num_edges = 0;
+	G->offsets = NULL;
+	G->neighbors = NULL;
+	G->costs = NULL;
+	G->is_dense = 0;
+	G->mapped_base = NULL;
+	G->mapped_size = 0;
+	G->persons_capacity = 0;
+	G->edges_capacity = 0;
+}
 
-// Safe destructor: free the memory and set members to default values.
-void	Person_Clear(Person *P)
+// Safe destructor: free the memory allocated for the Graph and set members to default values.
+void	Graph_Clear(Graph *G)
 {
-	if (P->num_neighbors > 0)
+	if (G->mapped_base != NULL) munmap(G->mapped_base, G->mapped_size);
+	else
 	{
-		free((char*) P->neighbors);
-		free((char*) P->costs);
+		free((char*) G->offsets);
+		free((char*) G->neighbors);
+		free((char*) G->costs);
 	}
-	P->num_neighbors = 0;
-	P->neighbors = NULL;
-	P->costs = NULL;
+	Graph_Defaults(G);
 }
 
-// Safe allocate arrays for neighbors and costs of size 'num_neighbors' each.
-// The member 'num_neighbors' of the person will be set to the correct value.
-// In case of error, an Error instance will be returned.
-Error	Person_Allocate(Person *P, int num_neighbors)
+// The object in the position 'k' of the arrays of the graph, which belongs to the adjacency list of person 'person_i'.
+int		Graph_Neighbor(const Graph *G, int person_i, int k)
 {
-	Error error = {-1, "Error: no memory for the allocation of a person in 'Person_Allocate'"};
+	return (G->neighbors != NULL ? G->neighbors[k] : k - G->offsets[person_i]);
+}
+
+// Safe allocate the arrays of the Graph for 'num_persons' persons and 'num_edges' edges, without the 'neighbors'
+// array if 'store_neighbors' is '0'. Used by 'Graph_Allocate' and 'Graph_Allocate_dense'.
+// The 'offsets' array is initialized to zero, the adjacency lists are left uninitialized.
+// The arrays already allocated are kept if they are big enough.
+// In case of error, an Error instance will be returned and the Graph will be empty.
+Error	Graph_Allocate_arrays(Graph *G, int num_persons, int num_edges, int store_neighbors)
+{
+	Error error = {-1, "Error: no memory for the allocation of the graph in 'Graph_Allocate'"};
+	int		persons_capacity = num_persons;
+	int		edges_capacity = num_edges;
+	
+	if (num_persons < 0 || num_edges < 0)
+	{
+		Graph_Clear(G);
+		strcpy(error.msg, "Error: can't allocate space for a negative number of persons or edges in 'Graph_Allocate'");
+		return error;
+	}
 	
-	// Clear the person just in case.
-	Person_Clear(P);
-	// Only try to allocate space for >= 0 number of neighbors.
-	if (num_neighbors >= 0)
+	// Reuse the arrays if they are big enough. A dense graph stored before has no 'neighbors' array.
+	if (G->mapped_base == NULL && G->offsets != NULL && num_persons <= G->persons_capacity && num_edges <= G->edges_capacity)
 	{
-		// Try to allocate the neighbors.
-		P->neighbors = (int*) malloc(num_neighbors * sizeof(int));
-		if (P->neighbors == NULL) return error;
-		// Try to allocate the costs.
-		P->costs = (costType*) malloc(num_neighbors * sizeof(costType));
-		if (P->costs == NULL)
+		if (!store_neighbors)
+		{
+			free((char*) G->neighbors);
+			G->neighbors = NULL;
+		}
+		else if (G->neighbors == NULL) G->neighbors = (int*) malloc((G->edges_capacity > 0 ? G->edges_capacity : 1) * sizeof(int));
+		if (store_neighbors && G->neighbors == NULL)
 		{
-			free((char *) P->neighbors);
-			P->neighbors = NULL;
+			Graph_Clear(G);
 			return error;
 		}
-		P->num_neighbors = num_neighbors;
+		memset(G->offsets, 0, (num_persons + 1) * sizeof(int));
+		G->num_persons = num_persons;
+		G->num_edges = num_edges;
+		G->offsets[num_persons] = num_edges;
+		G->is_dense = 0;
 		
 		error.code = 1;
 		strcpy(error.msg, "OK");
 		return error;
 	}
-	// Error if negative number of neighbors.
-	strcpy(error.msg, "Error: can't allocate space for a negative number of neighbors of a person in 'Person_Allocate'");
+	
+	// The new arrays also keep room for the biggest graph stored before.
+	if (G->mapped_base == NULL && G->persons_capacity > num_persons) persons_capacity = G->persons_capacity;
+	if (G->mapped_base == NULL && G->edges_capacity > num_edges) edges_capacity = G->edges_capacity;
+	
+	// Clear the graph just in case.
+	Graph_Clear(G);
+	G->offsets = (int*) calloc((persons_capacity + 1) * sizeof(int), 1);
+	// Allocate at least one element so that an empty graph is not mistaken for an allocation failure.
+	if (store_neighbors) G->neighbors = (int*) malloc((edges_capacity > 0 ? edges_capacity : 1) * sizeof(int));
+	G->costs = (costType*) malloc((edges_capacity > 0 ? edges_capacity : 1) * sizeof(costType));
+	if (G->offsets == NULL || (store_neighbors && G->neighbors == NULL) || G->costs == NULL)
+	{
+		Graph_Clear(G);
+		return error;
+	}
+	G->num_persons = num_persons;
+	G->num_edges = num_edges;
+	G->offsets[num_persons] = num_edges;
+	G->persons_capacity = persons_capacity;
+	G->edges_capacity = edges_capacity;
+	
+	error.code = 1;
+	strcpy(error.msg, "OK");
 	return error;
 }
 
-//*****************************************************************************************
-// GRAPH STRUCTURE
-/*
-	Since the Auction algorithm only works with the adjacency lists of the Persons,
-	then we will only store such adjacency lists. A Graph structure is simply a
-	pointer to an array of Person structures.
-*/
-typedef Person* Graph;
-
-//***********************************
-// GRAPH METHODS
+// Safe allocate the arrays of the Graph for 'num_persons' persons and 'num_edges' edges.
+// The 'offsets' array is initialized to zero, the adjacency lists are left uninitialized.
+// The arrays already allocated are kept if they are big enough, so replacing the graph by one of similar size
+// does not allocate memory.
+// In case of error, an Error instance will be returned and the Graph will be empty.
+Error	Graph_Allocate(Graph *G, int num_persons, int num_edges)
+{
+	return Graph_Allocate_arrays(G, num_persons, num_edges, 1);
+}
 
-// Safe destructor: free the memory allocated for each person in the Graph and the Graph (array) itself.
-// The number of elements in the array is needed ('num_persons' argument).
-// Also set members to default values.
-void	Graph_Clear(Graph *Persons, int num_persons)
+// Safe allocate the arrays of a dense Graph, in which the 'num_persons' persons are adjacent to all the 'num_objects'
+// objects. The 'offsets' array is filled and 'neighbors' is NULL, only the costs (a row-major matrix) are left uninitialized.
+// In case of error, an Error instance will be returned and the Graph will be empty.
+Error	Graph_Allocate_dense(Graph *G, int num_persons, int num_objects)
 {
+	Error	error = {-1, "Error: the dense graph has too many edges in 'Graph_Allocate_dense'"};
+	
+	if ((long int)num_persons * num_objects > 2147483647)
+	{
+		Graph_Clear(G);
+		return error;
+	}
+	error = Graph_Allocate_arrays(G, num_persons, (num_persons > 0 && num_objects > 0 ? num_persons * num_objects : 0), 0);
+	if (error.code == -1)
+	{
+		strcat(error.msg, " In 'Graph_Allocate_dense'");
+		return error;
+	}
 	for(int person_i = 0; person_i < num_persons; ++person_i)
-		Person_Clear(&(*Persons)[person_i]);
-	free((char*) *Persons);
-	*Persons = NULL;
+		G->offsets[person_i + 1] = G->offsets[person_i] + num_objects;
+	G->is_dense = (num_persons > 0 && num_objects > 0);
+	
+	return error;
+}
+
+// Find out if every person is adjacent to all the 'num_objects' objects in increasing order,
+// and set the member 'is_dense' accordingly. A dense graph drops its 'neighbors' array (it is not
+// freed if the graph is inside a mapped file).
+void	Graph_Check_dense(Graph *G, int num_objects)
+{
+	if (G->neighbors == NULL) return;
+	G->is_dense = 0;
+	if (G->num_persons <= 0 || num_objects <= 0 || (long int)G->num_persons * num_objects != G->num_edges) return;
+	for(int person_i = 0; person_i < G->num_persons; ++person_i)
+		for(int k = 0; k < num_objects; ++k)
+			if (G->neighbors[G->offsets[person_i] + k] != k) return;
+	G->is_dense = 1;
+	if (G->mapped_base == NULL) free((char*) G->neighbors);
+	G->neighbors = NULL;
+}
+
+// Make sure that the arrays of the Graph have room for 'num_edges' edges, keeping its content. The capacity is at
+// least doubled each time it grows, so adding edges one at a time takes amortized constant time. A graph inside a
+// mapped file is copied to allocated memory, and a dense graph stores its 'neighbors' array again.
+// In case of error, an Error instance will be returned and the Graph is not changed.
+Error	Graph_Reserve_edges(Graph *G, int num_edges)
+{
+	Error		error = {-1, "Error: no memory for the allocation of the graph in 'Graph_Reserve_edges'"};
+	int			*offsets = G->offsets;
+	int			*neighbors = NULL;
+	costType	*costs = NULL;
+	int			capacity = G->edges_capacity;
+	
+	if (G->mapped_base == NULL && num_edges <= G->edges_capacity && G->neighbors != NULL)
+	{
+		error.code = 1;
+		strcpy(error.msg, "OK");
+		return error;
+	}
+	if (num_edges > capacity) capacity = (num_edges > 2 * capacity ? num_edges : 2 * capacity);
+	if (capacity < 1) capacity = 1;
+	
+	if (G->mapped_base != NULL)
+	{
+		offsets = (int*) malloc((G->num_persons + 1) * sizeof(int));
+		neighbors = (int*) malloc(capacity * sizeof(int));
+		costs = (costType*) malloc(capacity * sizeof(costType));
+		if (offsets == NULL || neighbors == NULL || costs == NULL)
+		{
+			free((char*) offsets);
+			free((char*) neighbors);
+			free((char*) costs);
+			return error;
+		}
+		memcpy(offsets, G->offsets, (G->num_persons + 1) * sizeof(int));
+		for(int person_i = 0; person_i < G->num_persons; ++person_i)
+			for(int k = G->offsets[person_i]; k < G->offsets[person_i + 1]; ++k)
+				neighbors[k] = Graph_Neighbor(G, person_i, k);
+		memcpy(costs, G->costs, G->num_edges * sizeof(costType));
+		munmap(G->mapped_base, G->mapped_size);
+		G->mapped_base = NULL;
+		G->mapped_size = 0;
+		G->persons_capacity = G->num_persons;
+	}
+	else
+	{
+		neighbors = (int*) realloc(G->neighbors, capacity * sizeof(int));
+		if (neighbors == NULL) return error;
+		if (G->neighbors == NULL)
+			for(int person_i = 0; person_i < G->num_persons; ++person_i)
+				for(int k = G->offsets[person_i]; k < G->offsets[person_i + 1]; ++k)
+					neighbors[k] = k - G->offsets[person_i];
+		G->neighbors = neighbors;
+		costs = (costType*) realloc(G->costs, capacity * sizeof(costType));
+		if (costs == NULL) return error;
+	}
+	G->offsets = offsets;
+	G->neighbors = neighbors;
+	G->costs = costs;
+	G->edges_capacity = capacity;
+	G->is_dense = 0;
+	
+	error.code = 1;
+	strcpy(error.msg, "OK");
+	return error;
+}
+
+// Find the position in the arrays 'neighbors' and 'costs' of the edge between person 'person_i' and object 'object_j'.
+// Returns -1 if there is no such edge.
+int		Graph_Find_edge(const Graph *G, int person_i, int object_j)
+{
+	if (G->neighbors == NULL)
+		return (object_j < G->offsets[person_i + 1] - G->offsets[person_i] ? G->offsets[person_i] + object_j : -1);
+	for(int k = G->offsets[person_i]; k < G->offsets[person_i + 1]; ++k)
+		if (G->neighbors[k] == object_j) return k;
+	return -1;
+}
+
+// Add the edge between person 'person_i' and object 'object_j' with cost 'cost' at the end of the adjacency list of the
+// person. The edges of the next persons are moved one position.
+// In case of error, an Error instance will be returned and the Graph is not changed.
+Error	Graph_Add_edge(Graph *G, int person_i, int object_j, costType cost)
+{
+	Error	error;
+	int		position = 0;
+	
+	error = Graph_Reserve_edges(G, G->num_edges + 1);
+	if (error.code == -1)
+	{
+		strcat(error.msg, " In 'Graph_Add_edge'");
+		return error;
+	}
+	position = G->offsets[person_i + 1];
+	memmove(G->neighbors + position + 1, G->neighbors + position, (G->num_edges - position) * sizeof(int));
+	memmove(G->costs + position + 1, G->costs + position, (G->num_edges - position) * sizeof(costType));
+	G->neighbors[position] = object_j;
+	G->costs[position] = cost;
+	for(int next_i = person_i + 1; next_i <= G->num_persons; ++next_i) ++G->offsets[next_i];
+	++G->num_edges;
+	G->is_dense = 0;
+	
+	return error;
+}
+
+// Remove the edge in the position 'position' of the arrays 'neighbors' and 'costs', which belongs to person 'person_i'.
+// The edges after it are moved one position. The graph must store its 'neighbors' array (see 'Graph_Reserve_edges').
+void	Graph_Remove_edge(Graph *G, int person_i, int position)
+{
+	memmove(G->neighbors + position, G->neighbors + position + 1, (G->num_edges - position - 1) * sizeof(int));
+	memmove(G->costs + position, G->costs + position + 1, (G->num_edges - position - 1) * sizeof(costType));
+	for(int next_i = person_i + 1; next_i <= G->num_persons; ++next_i) --G->offsets[next_i];
+	--G->num_edges;
+	G->is_dense = 0;
 }
 
-// Safe allocate the array of Person structures for 'num_persons' elements.
-// Every byte initialized to zero for safe memory free in case of errors.
-// If the memory was not allocated the pointer will point to NULL.
-void	Graph_Allocate(Graph *Persons, int num_persons)
+// Build in 'T' the graph seen from the objects: the adjacency list of object 'j' contains the persons adjacent to it,
+// in increasing order, and the costs of the edges. 'G' has 'num_objects' objects.
+// In case of error, an Error instance will be returned and 'T' will be empty.
+Error	Graph_Transpose(const Graph *G, int num_objects, Graph *T)
 {
-	if (*Persons != NULL) free((char*) *Persons);
-	*Persons = NULL;
-	*Persons = (Graph) calloc(num_persons * sizeof(Person), 1);
+	Error	error;
+	int		position = 0;
+	
+	// The transpose of a dense graph is dense, only the matrix of costs is transposed.
+	if (G->neighbors == NULL)
+	{
+		error = Graph_Allocate_dense(T, num_objects, G->num_persons);
+		if (error.code == -1)
+		{
+			strcat(error.msg, " In 'Graph_Transpose'");
+			return error;
+		}
+		for(int person_i = 0; person_i < G->num_persons; ++person_i)
+			for(int object_j = 0; object_j < num_objects; ++object_j)
+				T->costs[(long int)object_j * G->num_persons + person_i] = G->costs[(long int)person_i * num_objects + object_j];
+		return error;
+	}
+	
+	error = Graph_Allocate(T, num_objects, G->num_edges);
+	if (error.code == -1)
+	{
+		strcat(error.msg, " In 'Graph_Transpose'");
+		return error;
+	}
+	
+	// Count the neighbors of each object in 'offsets[j + 1]' and turn the counts into the beginnings.
+	T->offsets[num_objects] = 0;
+	for(int k = 0; k < G->num_edges; ++k)
+		++T->offsets[G->neighbors[k] + 1];
+	for(int object_j = 0; object_j < num_objects; ++object_j)
+		T->offsets[object_j + 1] += T->offsets[object_j];
+	
+	// Place the edges, using 'offsets[j]' as the next free position of object 'j'.
+	for(int person_i = 0; person_i < G->num_persons; ++person_i)
+		for(int k = G->offsets[person_i]; k < G->offsets[person_i + 1]; ++k)
+		{
+			position = T->offsets[G->neighbors[k]]++;
+			T->neighbors[position] = person_i;
+			T->costs[position] = G->costs[k];
+		}
+	
+	// Now 'offsets[j]' is the end of the list of object 'j', i.e. the beginning of the next one.
+	for(int object_j = num_objects; object_j > 0; --object_j)
+		T->offsets[object_j] = T->offsets[object_j - 1];
+	T->offsets[0] = 0;
+	Graph_Check_dense(T, G->num_persons);
+	
+	return error;
 }
 
 #endif